@@ -0,0 +1,38 @@
+/**************************************************************************************************
+ * @file arena.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief arena module, bump allocator for memory that lives for a single turn (such as moves lists).
+ * Every solver owns its arena, so turns make no heap calls (and take no allocator lock when games run on threads).
+**************************************************************************************************/
+#include <stdlib.h>
+#include "arena.h"
+
+t_error_code initialize_arena(t_arena *arena, size_t capacity) {
+    arena->memory = (char *) malloc(capacity ? capacity : 1);
+    arena->capacity = arena->memory ? capacity : 0;
+    arena->used = 0;
+    if (!arena->memory)
+        return ERROR_ARENA_MEMORY_ALLOC;
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_arena(t_arena *arena) {
+    free(arena->memory);
+    arena->memory = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+void reset_arena(t_arena *arena) {
+    arena->used = 0;
+}
+
+void *allocate_from_arena(t_arena *arena, size_t size) {
+    size_t offset = (arena->used + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+    if (offset > arena->capacity || size > arena->capacity - offset)
+        return NULL;
+    arena->used = offset + size;
+    return arena->memory + offset;
+}
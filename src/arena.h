@@ -0,0 +1,57 @@
+/**************************************************************************************************
+ * @file arena.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for arena module, exports a bump allocator for memory that lives for a single turn.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_ARENA_H
+#define MINESWEEPERSOLVER_ARENA_H
+
+#include <stddef.h>
+#include "error_codes.h"
+
+#define ARENA_ALIGNMENT 16
+
+/**
+ * Struct for arena, a single heap block that serves allocations by bumping an offset.
+ * All allocations are released at once, by resetting the arena.
+ */
+struct arena {
+    char *memory;
+    size_t capacity;    // Number of bytes in memory.
+    size_t used;        // Number of bytes served since last reset.
+};
+typedef struct arena t_arena;
+
+/**
+ * @brief Initialize arena memory.
+ * @param arena Pointer to arena.
+ * @param capacity Number of bytes the arena can serve between resets.
+ * @return Error code.
+ */
+t_error_code initialize_arena(t_arena *arena, size_t capacity);
+
+/**
+ * @brief Free arena memory.
+ * @param arena Pointer to arena.
+ * @return Void.
+ */
+void free_arena(t_arena *arena);
+
+/**
+ * @brief Release all arena allocations.
+ * @param arena Pointer to arena.
+ * @return Void.
+ */
+void reset_arena(t_arena *arena);
+
+/**
+ * @brief Allocate memory from arena, aligned to ARENA_ALIGNMENT.
+ * @param arena Pointer to arena.
+ * @param size Number of bytes.
+ * @return Pointer to allocated memory, NULL if arena is exhausted.
+ */
+void *allocate_from_arena(t_arena *arena, size_t size);
+
+#endif //MINESWEEPERSOLVER_ARENA_H
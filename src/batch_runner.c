@@ -0,0 +1,339 @@
+/**************************************************************************************************
+ * @file batch_runner.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief batch_runner module, plays many seeded simulated games over all cores.
+ * Game lengths vary by orders of magnitude (some are lost on second turn, others take hundreds),
+ * so static partitioning leaves cores idle. Instead, games are split into small tasks (ranges of games),
+ * every worker thread owns a Chase-Lev work-stealing queue, pops its own tasks from the queue bottom,
+ * and once empty, steals tasks from the top of other queues.
+ * Every worker aggregates results into its own (thread stack) statistics, which are merged
+ * after all workers are joined, so no locks or shared counters are touched while playing.
+**************************************************************************************************/
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "common.h"
+#include "batch_runner.h"
+#include "board_analyzer.h"
+#include "minesweeper_solver_utils.h"
+
+#define TASK_GAMES_NUMBER 16
+#define CACHE_LINE_SIZE 64
+#define STEAL_ROUNDS_BEFORE_EXIT 2
+
+/**
+ * Struct for a task, range of games [first_game, last_game).
+ */
+struct task {
+    long first_game;
+    long last_game;
+};
+typedef struct task t_task;
+
+/**
+ * Struct for Chase-Lev work-stealing queue.
+ * Owner pushes and pops at bottom, thieves steal at top.
+ * All tasks are pushed before workers start, so the tasks buffer is never resized.
+ */
+struct work_queue {
+    atomic_long top;
+    char top_padding[CACHE_LINE_SIZE - sizeof(atomic_long)]; // Thieves and owner touch different lines.
+    atomic_long bottom;
+    t_task *tasks;
+    char bottom_padding[CACHE_LINE_SIZE - sizeof(atomic_long) - sizeof(t_task *)];
+};
+typedef struct work_queue t_work_queue;
+
+/**
+ * Struct for worker thread data.
+ */
+struct worker {
+    t_batch_statistics statistics; // Written once, when worker is done.
+    int worker_index;
+    t_error_code error_code;
+    struct batch *batch;
+};
+typedef struct worker t_worker;
+
+/**
+ * Struct for batch shared (read-only while playing) data.
+ */
+struct batch {
+    t_board_size board_size;
+    int number_of_mines;
+    uint64_t seed;
+    int workers_number;
+    t_work_queue *queues;
+    t_worker *workers;
+};
+typedef struct batch t_batch;
+
+typedef enum {
+    TASK_SUCCESS,
+    TASK_EMPTY,
+    TASK_ABORT  // Lost a race over the task, queue may still contain tasks.
+} t_task_result;
+
+/**
+ * @brief Push a task at queue bottom (owner only).
+ * @param queue The queue.
+ * @param task The task.
+ * @return Void.
+ */
+void push_task(t_work_queue *queue, t_task task) {
+    long bottom = atomic_load_explicit(&queue->bottom, memory_order_relaxed);
+    queue->tasks[bottom] = task;
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&queue->bottom, bottom + 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Pop a task from queue bottom (owner only).
+ * @param queue The queue.
+ * @param task Pointer to popped task.
+ * @return Task result.
+ */
+t_task_result pop_task(t_work_queue *queue, t_task *task) {
+    long bottom = atomic_load_explicit(&queue->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&queue->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = atomic_load_explicit(&queue->top, memory_order_relaxed);
+    if (top > bottom) {
+        atomic_store_explicit(&queue->bottom, bottom + 1, memory_order_relaxed);
+        return TASK_EMPTY;
+    }
+    *task = queue->tasks[bottom];
+    if (top == bottom) {
+        // Last task, race against thieves.
+        bool is_won = atomic_compare_exchange_strong_explicit(&queue->top, &top, top + 1,
+                                                              memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&queue->bottom, bottom + 1, memory_order_relaxed);
+        return is_won ? TASK_SUCCESS : TASK_EMPTY;
+    }
+    return TASK_SUCCESS;
+}
+
+/**
+ * @brief Steal a task from queue top (any thread).
+ * @param queue The queue.
+ * @param task Pointer to stolen task.
+ * @return Task result.
+ */
+t_task_result steal_task(t_work_queue *queue, t_task *task) {
+    long top = atomic_load_explicit(&queue->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&queue->bottom, memory_order_acquire);
+    if (top >= bottom)
+        return TASK_EMPTY;
+    *task = queue->tasks[top];
+    if (!atomic_compare_exchange_strong_explicit(&queue->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed))
+        return TASK_ABORT;
+    return TASK_SUCCESS;
+}
+
+/**
+ * @brief Get next task of a worker, from its own queue, or stolen from other queues.
+ * Victims are scanned round robin, starting from the next worker.
+ * @param worker The worker.
+ * @param task Pointer to task.
+ * @param statistics Pointer to worker statistics (counts steals).
+ * @return Boolean, true if a task was found, false if all queues are empty.
+ */
+bool get_next_task(t_worker *worker, t_task *task, t_batch_statistics *statistics) {
+    t_batch *batch = worker->batch;
+    if (pop_task(&batch->queues[worker->worker_index], task) == TASK_SUCCESS)
+        return true;
+    int empty_rounds = 0;
+    while (empty_rounds < STEAL_ROUNDS_BEFORE_EXIT) {
+        bool is_aborted = false;
+        for (int i = 1; i < batch->workers_number; i++) {
+            int victim = (worker->worker_index + i) % batch->workers_number;
+            t_task_result result = steal_task(&batch->queues[victim], task);
+            if (result == TASK_SUCCESS) {
+                statistics->steals++;
+                return true;
+            }
+            if (result == TASK_ABORT)
+                is_aborted = true;
+        }
+        // Tasks are never added while playing, so queues that were seen empty (without races) stay empty.
+        empty_rounds = is_aborted ? 0 : empty_rounds + 1;
+    }
+    return false;
+}
+
+t_error_code play_simulated_game(t_solver *solver, t_game *game, uint64_t seed, t_batch_statistics *statistics) {
+    t_error_code error_code = RETURN_CODE_SUCCESS;
+    t_game_status game_status = GAME_ON;
+    int max_turns = game->board_size.rows * game->board_size.cols;
+    reset_game(game, seed);
+    seed_random_generator(&solver->random_generator, ~seed); // Not correlated with mines placement.
+    t_board board = initialize_board(game->board_size);
+    if (!board.cells)
+        return ERROR_INITIALIZE_BOARD_MEMORY;
+    t_moves moves;
+    error_code = get_first_moves(solver, &moves);
+    if (error_code)
+        goto lblGameError;
+    for (int turn = 0; turn <= max_turns; turn++) {
+        error_code = simulate_moves(game, moves);
+        if (error_code)
+            goto lblGameError;
+        update_board_from_game(game, board, &game_status);
+        if (game_status != GAME_ON)
+            goto lblCleanup;
+        error_code = get_moves(solver, board, &moves);
+        if (error_code)
+            goto lblGameError;
+        statistics->turns++;
+        if (moves.is_guess)
+            statistics->guesses++;
+    }
+    lblGameError:
+    statistics->errors++;
+    lblCleanup:
+    statistics->games++;
+    if (game_status == WIN)
+        statistics->wins++;
+    free_board(board);
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Worker thread routine, plays tasks until all queues are empty.
+ * @param worker_ptr Pointer to worker.
+ * @return NULL.
+ */
+void *run_worker(void *worker_ptr) {
+    t_worker *worker = (t_worker *) worker_ptr;
+    t_batch *batch = worker->batch;
+    t_solver solver;
+    t_game game;
+    t_task task;
+    t_batch_statistics statistics = {0};
+    worker->error_code = initialize_solver(&solver, batch->board_size, batch->number_of_mines, batch->seed);
+    if (worker->error_code)
+        return NULL;
+    worker->error_code = initialize_game(&game, batch->board_size, batch->number_of_mines, batch->seed);
+    if (worker->error_code)
+        goto lblFreeSolver;
+    while (get_next_task(worker, &task, &statistics)) {
+        for (long game_index = task.first_game; game_index < task.last_game; game_index++) {
+            worker->error_code = play_simulated_game(&solver, &game, batch->seed + game_index, &statistics);
+            if (worker->error_code)
+                goto lblFreeGame;
+        }
+    }
+    lblFreeGame:
+    worker->statistics = statistics;
+    free_game(&game);
+    lblFreeSolver:
+    free_solver(&solver);
+    return NULL;
+}
+
+int get_cores_number() {
+#ifdef _WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    int cores_number = (int) system_info.dwNumberOfProcessors;
+#else
+    int cores_number = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return cores_number > 0 ? cores_number : 1;
+}
+
+/**
+ * @brief Split games into tasks, and push them into queues (contiguous share of tasks for every queue).
+ * @param batch The batch.
+ * @param games_number Number of games.
+ * @return Error code.
+ */
+t_error_code fill_queues(t_batch *batch, long games_number) {
+    long tasks_number = (games_number + TASK_GAMES_NUMBER - 1) / TASK_GAMES_NUMBER;
+    long tasks_per_queue = (tasks_number + batch->workers_number - 1) / batch->workers_number;
+    long current_task = 0;
+    for (int i = 0; i < batch->workers_number; i++) {
+        t_work_queue *queue = &batch->queues[i];
+        atomic_init(&queue->top, 0);
+        atomic_init(&queue->bottom, 0);
+        queue->tasks = (t_task *) malloc(sizeof(t_task) * (tasks_per_queue ? tasks_per_queue : 1));
+        if (!queue->tasks)
+            return ERROR_BATCH_MEMORY_ALLOC;
+        // Pushed in reverse, so the owner pops its games in increasing order.
+        long queue_last_task = current_task + tasks_per_queue < tasks_number ?
+                               current_task + tasks_per_queue : tasks_number;
+        for (long task_index = queue_last_task - 1; task_index >= current_task; task_index--) {
+            long last_game = (task_index + 1) * TASK_GAMES_NUMBER;
+            t_task task = {task_index * TASK_GAMES_NUMBER, last_game < games_number ? last_game : games_number};
+            push_task(queue, task);
+        }
+        current_task = queue_last_task;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Merge worker statistics into batch statistics.
+ * @param statistics Pointer to merged statistics.
+ * @param worker_statistics Pointer to worker statistics.
+ * @return Void.
+ */
+void merge_statistics(t_batch_statistics *statistics, t_batch_statistics *worker_statistics) {
+    statistics->games += worker_statistics->games;
+    statistics->wins += worker_statistics->wins;
+    statistics->errors += worker_statistics->errors;
+    statistics->guesses += worker_statistics->guesses;
+    statistics->turns += worker_statistics->turns;
+    statistics->steals += worker_statistics->steals;
+}
+
+t_error_code run_batch(t_board_size board_size, int number_of_mines, long games_number, int threads_number,
+                       uint64_t seed, t_batch_statistics *statistics) {
+    t_error_code error_code = RETURN_CODE_SUCCESS;
+    t_batch batch = {board_size, number_of_mines, seed, threads_number ? threads_number : get_cores_number()};
+    t_batch_statistics empty_statistics = {0};
+    *statistics = empty_statistics;
+    batch.queues = (t_work_queue *) calloc(batch.workers_number, sizeof(t_work_queue));
+    batch.workers = (t_worker *) calloc(batch.workers_number, sizeof(t_worker));
+    pthread_t *threads = (pthread_t *) calloc(batch.workers_number, sizeof(pthread_t));
+    int started_threads = 0;
+    if (!batch.queues || !batch.workers || !threads) {
+        error_code = ERROR_BATCH_MEMORY_ALLOC;
+        goto lblCleanup;
+    }
+    error_code = fill_queues(&batch, games_number);
+    if (error_code)
+        goto lblCleanup;
+    for (; started_threads < batch.workers_number; started_threads++) {
+        t_worker *worker = &batch.workers[started_threads];
+        worker->worker_index = started_threads;
+        worker->batch = &batch;
+        if (pthread_create(&threads[started_threads], NULL, run_worker, worker)) {
+            error_code = ERROR_BATCH_THREAD_CREATE;
+            break;
+        }
+    }
+    for (int i = 0; i < started_threads; i++) {
+        pthread_join(threads[i], NULL);
+        merge_statistics(statistics, &batch.workers[i].statistics);
+        if (batch.workers[i].error_code && !error_code)
+            error_code = batch.workers[i].error_code;
+    }
+    lblCleanup:
+    if (batch.queues)
+        for (int i = 0; i < batch.workers_number; i++)
+            free(batch.queues[i].tasks);
+    free(batch.queues);
+    free(batch.workers);
+    free(threads);
+    return error_code;
+}
@@ -0,0 +1,63 @@
+/**************************************************************************************************
+ * @file batch_runner.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for batch_runner module, exports multi-core simulated games runner.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_BATCH_RUNNER_H
+#define MINESWEEPERSOLVER_BATCH_RUNNER_H
+
+#include <stdint.h>
+#include "error_codes.h"
+#include "board.h"
+#include "solver.h"
+#include "simulator.h"
+
+/**
+ * Struct for results of simulated games.
+ */
+struct batch_statistics {
+    long games;
+    long wins;
+    long errors;    // Games that ended with an error (e.g. illegal board or no progress).
+    long guesses;
+    long turns;
+    long steals;    // Number of tasks stolen between worker threads.
+};
+typedef struct batch_statistics t_batch_statistics;
+
+/**
+ * @brief Play a single simulated game to its end, using the solver.
+ * Both the game and the solver random generator are seeded by the seed,
+ * so a game result depends only on its seed (and not on the playing thread).
+ * @param solver Solver context.
+ * @param game Pointer to initialized game.
+ * @param seed Seed of game.
+ * @param statistics Pointer to statistics to update.
+ * @return Error code, only fatal (memory) errors, game errors are counted in statistics.
+ */
+t_error_code play_simulated_game(t_solver *solver, t_game *game, uint64_t seed, t_batch_statistics *statistics);
+
+/**
+ * @brief Run a batch of seeded simulated games over all cores.
+ * Game i is seeded by seed + i. Games are split into tasks that are distributed between per-thread
+ * work-stealing queues, every thread aggregates its own statistics, and those are merged at the end.
+ * @param board_size Board size of games.
+ * @param number_of_mines Number of mines in games.
+ * @param games_number Number of games.
+ * @param threads_number Number of threads, 0 for number of cores.
+ * @param seed Base seed.
+ * @param statistics Pointer to merged statistics.
+ * @return Error code.
+ */
+t_error_code run_batch(t_board_size board_size, int number_of_mines, long games_number, int threads_number,
+                       uint64_t seed, t_batch_statistics *statistics);
+
+/**
+ * @brief Get number of online cores.
+ * @return Number of cores (at least 1).
+ */
+int get_cores_number();
+
+#endif //MINESWEEPERSOLVER_BATCH_RUNNER_H
@@ -0,0 +1,201 @@
+/**************************************************************************************************
+ * @file bitboard.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief bitboard module, keeps board bitplanes and counts neighbors of 64 cells at once.
+ * Unknown, mine and revealed cells have a plane each, and cell numbers are bit-sliced over 4 planes,
+ * so they are compared against bit-sliced neighbor counts with word operations only.
+**************************************************************************************************/
+#include <string.h>
+#include "bitboard.h"
+
+int get_words_per_row(int cols) {
+    return (cols + BITBOARD_WORD_BITS - 1) / BITBOARD_WORD_BITS;
+}
+
+size_t get_changed_words_length(t_board_size board_size) {
+    size_t plane_words = (size_t) board_size.rows * get_words_per_row(board_size.cols);
+    return (plane_words + BITBOARD_WORD_BITS - 1) / BITBOARD_WORD_BITS;
+}
+
+/**
+ * @brief Mark a plane word of board as changed.
+ * @param board The board.
+ * @param word_index Word index in plane (row-major).
+ * @return Void.
+ */
+void mark_changed_word(t_board board, size_t word_index) {
+    if (board.changed_words)
+        board.changed_words[word_index / BITBOARD_WORD_BITS] |= (uint64_t) 1 << (word_index % BITBOARD_WORD_BITS);
+}
+
+void reset_board_planes(t_board board) {
+    size_t plane_words = (size_t) board.size.rows * board.words_per_row;
+    memset(board.planes, 0, sizeof(uint64_t) * plane_words * BOARD_PLANES_NUMBER);
+    for (size_t i = 0; board.changed_words && i < plane_words; i++)
+        mark_changed_word(board, i);
+    for (int row = 0; row < board.size.rows; row++) {
+        uint64_t *unknown_row = BOARD_PLANE_ROW(board, UNKNOWN_PLANE, row);
+        for (int col = 0; col < board.size.cols; col++)
+            unknown_row[col / BITBOARD_WORD_BITS] |= (uint64_t) 1 << (col % BITBOARD_WORD_BITS);
+    }
+}
+
+void set_board_plane_cell(t_board board, t_board_plane plane, int row, int col, bool is_set) {
+    uint64_t bit = (uint64_t) 1 << (col % BITBOARD_WORD_BITS);
+    uint64_t *plane_word = BOARD_PLANE_ROW(board, plane, row) + col / BITBOARD_WORD_BITS;
+    *plane_word = is_set ? (*plane_word | bit) : (*plane_word & ~bit);
+}
+
+void set_board_cell(t_board board, int row, int col, t_cell_type cell_value) {
+    bool is_revealed = cell_value != UNKNOWN_CELL && cell_value != MINE;
+    BOARD_CELL(board, row, col) = cell_value;
+    mark_changed_word(board, (size_t) row * board.words_per_row + col / BITBOARD_WORD_BITS);
+    for (int plane = 0; plane < BOARD_PLANES_NUMBER; plane++) {
+        bool is_set;
+        if (plane == UNKNOWN_PLANE)
+            is_set = cell_value == UNKNOWN_CELL;
+        else if (plane == MINE_PLANE)
+            is_set = cell_value == MINE;
+        else if (plane == REVEALED_PLANE)
+            is_set = is_revealed;
+        else
+            is_set = is_revealed && (((int) cell_value >> (plane - NUMBER_PLANE)) & 1);
+        set_board_plane_cell(board, (t_board_plane) plane, row, col, is_set);
+    }
+}
+
+bool is_board_plane_set(t_board board, t_board_plane plane, int row, int col) {
+    return (BOARD_PLANE_ROW(board, plane, row)[col / BITBOARD_WORD_BITS] >> (col % BITBOARD_WORD_BITS)) & 1;
+}
+
+int get_lowest_bit_index(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (int) index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+/**
+ * @brief Get, for every cell of a row word, the bit of the previous column (a shift across words).
+ * @param plane_row Bitplane row.
+ * @param word Word index in row.
+ * @return Shifted word.
+ */
+uint64_t get_previous_column_word(const uint64_t *plane_row, int word) {
+    uint64_t carry = word > 0 ? plane_row[word - 1] >> (BITBOARD_WORD_BITS - 1) : 0;
+    return (plane_row[word] << 1) | carry;
+}
+
+/**
+ * @brief Get, for every cell of a row word, the bit of the next column (a shift across words).
+ * @param plane_row Bitplane row.
+ * @param word Word index in row.
+ * @param words_per_row Number of words in row.
+ * @return Shifted word.
+ */
+uint64_t get_next_column_word(const uint64_t *plane_row, int word, int words_per_row) {
+    uint64_t carry = word + 1 < words_per_row ? plane_row[word + 1] << (BITBOARD_WORD_BITS - 1) : 0;
+    return (plane_row[word] >> 1) | carry;
+}
+
+/**
+ * @brief Get the mask of board columns in a row word (bits beyond the last column are clear).
+ * @param board The board.
+ * @param word Word index in row.
+ * @return Columns mask.
+ */
+uint64_t get_columns_mask(t_board board, int word) {
+    int columns = board.size.cols - word * BITBOARD_WORD_BITS;
+    return columns >= BITBOARD_WORD_BITS ? ~(uint64_t) 0 : ((uint64_t) 1 << columns) - 1;
+}
+
+/**
+ * @brief Get the 8 neighbor words of a row word, shifted to align with the cells of word.
+ * @param board The board.
+ * @param plane The bitplane.
+ * @param row Row index.
+ * @param word Word index in row.
+ * @param neighbors Array to set, of 8 words.
+ * @return Void.
+ */
+void get_row_neighbor_words(t_board board, t_board_plane plane, int row, int word, uint64_t neighbors[8]) {
+    int neighbors_number = 0;
+    uint64_t columns_mask = get_columns_mask(board, word);
+    for (int k = 0; k < 8; k++)
+        neighbors[k] = 0;
+    for (int neighbor_row = row - 1; neighbor_row <= row + 1; neighbor_row++) {
+        if (neighbor_row < 0 || neighbor_row >= board.size.rows)
+            continue;
+        const uint64_t *plane_row = BOARD_PLANE_ROW(board, plane, neighbor_row);
+        neighbors[neighbors_number++] = get_previous_column_word(plane_row, word) & columns_mask;
+        neighbors[neighbors_number++] = get_next_column_word(plane_row, word, board.words_per_row);
+        if (neighbor_row != row)
+            neighbors[neighbors_number++] = plane_row[word];
+    }
+}
+
+uint64_t get_row_neighbors_mask(t_board board, t_board_plane plane, int row, int word) {
+    uint64_t neighbors[8];
+    uint64_t mask = 0;
+    get_row_neighbor_words(board, plane, row, word, neighbors);
+    for (int k = 0; k < 8; k++)
+        mask |= neighbors[k];
+    return mask;
+}
+
+void count_row_neighbors(t_board board, t_board_plane plane, int row, int word,
+                         uint64_t counts[COUNT_PLANES_NUMBER]) {
+    uint64_t neighbors[8];
+    get_row_neighbor_words(board, plane, row, word, neighbors);
+    for (int i = 0; i < COUNT_PLANES_NUMBER; i++)
+        counts[i] = 0;
+    for (int k = 0; k < 8; k++) {
+        uint64_t carry = neighbors[k];
+        for (int i = 0; i < COUNT_PLANES_NUMBER && carry; i++) {
+            uint64_t sum = counts[i] ^ carry;
+            carry &= counts[i];
+            counts[i] = sum;
+        }
+    }
+}
+
+void add_counts(const uint64_t first[COUNT_PLANES_NUMBER], const uint64_t second[COUNT_PLANES_NUMBER],
+                uint64_t sum[COUNT_PLANES_NUMBER]) {
+    uint64_t carry = 0;
+    for (int i = 0; i < COUNT_PLANES_NUMBER; i++) {
+        uint64_t half_sum = first[i] ^ second[i];
+        uint64_t next_carry = (first[i] & second[i]) | (half_sum & carry);
+        sum[i] = half_sum ^ carry;
+        carry = next_carry;
+    }
+}
+
+uint64_t get_greater_mask(const uint64_t first[COUNT_PLANES_NUMBER], const uint64_t second[COUNT_PLANES_NUMBER]) {
+    uint64_t greater = 0, equal = ~(uint64_t) 0;
+    for (int i = COUNT_PLANES_NUMBER - 1; i >= 0; i--) {
+        greater |= equal & first[i] & ~second[i];
+        equal &= ~(first[i] ^ second[i]);
+    }
+    return greater;
+}
+
+int get_count_value(const uint64_t counts[COUNT_PLANES_NUMBER], int bit) {
+    int value = 0;
+    for (int i = 0; i < COUNT_PLANES_NUMBER; i++)
+        value |= (int) ((counts[i] >> bit) & 1) << i;
+    return value;
+}
+
+int count_plane_cells(t_board board, t_board_plane plane) {
+    const uint64_t *plane_words = BOARD_PLANE_ROW(board, plane, 0);
+    size_t plane_words_number = (size_t) board.size.rows * board.words_per_row;
+    int cells = 0;
+    for (size_t i = 0; i < plane_words_number; i++)
+        cells += POPCOUNT64(plane_words[i]);
+    return cells;
+}
@@ -0,0 +1,143 @@
+/**************************************************************************************************
+ * @file bitboard.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for bitboard module, exports board bitplanes updates and bit-parallel neighbor counting.
+ * A bitplane word holds 64 cells of a row, so neighbor counts of a whole word are computed by adding
+ * shifted words of the rows above, below and of the cell row itself.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_BITBOARD_H
+#define MINESWEEPERSOLVER_BITBOARD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "board.h"
+
+#define BITBOARD_WORD_BITS 64
+#define COUNT_PLANES_NUMBER 4   // Bit-slices of neighbor counts (0 to 8).
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define POPCOUNT64(word) ((int) __popcnt64(word))
+#else
+#define POPCOUNT64(word) __builtin_popcountll(word)
+#endif
+
+/**
+ * @brief Get the length of a bitplane row.
+ * @param cols Number of board columns.
+ * @return Number of 64-bit words in a row.
+ */
+int get_words_per_row(int cols);
+
+/**
+ * @brief Get the length of a board changed words bitmap (a bit for every word of a bitplane).
+ * @param board_size Board size.
+ * @return Number of 64-bit words in bitmap.
+ */
+size_t get_changed_words_length(t_board_size board_size);
+
+/**
+ * @brief Set all board bitplanes to an unknown board (cells are not changed), and mark all words as changed.
+ * @param board The board.
+ * @return Void.
+ */
+void reset_board_planes(t_board board);
+
+/**
+ * @brief Set a board cell, and its bits in all bitplanes (its word is marked as changed).
+ * @param board The board.
+ * @param row Cell row.
+ * @param col Cell column.
+ * @param cell_value Cell value.
+ * @return Void.
+ */
+void set_board_cell(t_board board, int row, int col, t_cell_type cell_value);
+
+/**
+ * @brief Set a cell bit in a single bitplane (cells are not changed).
+ * @param board The board.
+ * @param plane The bitplane.
+ * @param row Cell row.
+ * @param col Cell column.
+ * @param is_set Whether bit is set.
+ * @return Void.
+ */
+void set_board_plane_cell(t_board board, t_board_plane plane, int row, int col, bool is_set);
+
+/**
+ * @brief Check whether a cell bit is set in a bitplane.
+ * @param board The board.
+ * @param plane The bitplane.
+ * @param row Cell row.
+ * @param col Cell column.
+ * @return Boolean, true if cell bit is set.
+ */
+bool is_board_plane_set(t_board board, t_board_plane plane, int row, int col);
+
+/**
+ * @brief Get the index of the lowest set bit of a word.
+ * @param word Non-zero word.
+ * @return Bit index.
+ */
+int get_lowest_bit_index(uint64_t word);
+
+/**
+ * @brief Get the cells of a row word that have at least one neighbor set in a bitplane.
+ * @param board The board.
+ * @param plane The bitplane.
+ * @param row Row index.
+ * @param word Word index in row.
+ * @return Mask of cells.
+ */
+uint64_t get_row_neighbors_mask(t_board board, t_board_plane plane, int row, int word);
+
+/**
+ * @brief Count the neighbors set in a bitplane, for all cells of a row word at once.
+ * The 8 shifted neighbor words are added into bit-sliced counters.
+ * @param board The board.
+ * @param plane The bitplane.
+ * @param row Row index.
+ * @param word Word index in row.
+ * @param counts Bit-sliced counts to set, bit i of a cell count is in counts[i].
+ * @return Void.
+ */
+void count_row_neighbors(t_board board, t_board_plane plane, int row, int word,
+                         uint64_t counts[COUNT_PLANES_NUMBER]);
+
+/**
+ * @brief Add two bit-sliced counts, for all cells of a word at once.
+ * @param first First counts.
+ * @param second Second counts.
+ * @param sum Counts to set to the sum (sums are assumed to fit COUNT_PLANES_NUMBER bits).
+ * @return Void.
+ */
+void add_counts(const uint64_t first[COUNT_PLANES_NUMBER], const uint64_t second[COUNT_PLANES_NUMBER],
+                uint64_t sum[COUNT_PLANES_NUMBER]);
+
+/**
+ * @brief Compare two bit-sliced counts, for all cells of a word at once.
+ * @param first First counts.
+ * @param second Second counts.
+ * @return Mask of cells whose first count is greater than the second.
+ */
+uint64_t get_greater_mask(const uint64_t first[COUNT_PLANES_NUMBER], const uint64_t second[COUNT_PLANES_NUMBER]);
+
+/**
+ * @brief Get the count of a single cell out of bit-sliced counts.
+ * @param counts Bit-sliced counts.
+ * @param bit Bit index of cell in word.
+ * @return Cell count.
+ */
+int get_count_value(const uint64_t counts[COUNT_PLANES_NUMBER], int bit);
+
+/**
+ * @brief Count the cells set in a bitplane.
+ * @param board The board.
+ * @param plane The bitplane.
+ * @return Number of cells.
+ */
+int count_plane_cells(t_board board, t_board_plane plane);
+
+#endif //MINESWEEPERSOLVER_BITBOARD_H
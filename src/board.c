@@ -17,7 +17,9 @@
 #include "logger.h"
 #include "common.h"
 #include "board.h"
+#include "bitboard.h"
 #include "commander.h"
+#include "solver.h"
 
 /**
  * Macro to access a single pixel value by indexes and image size.
@@ -132,12 +134,12 @@ bool is_colors_equal(t_color color1, t_color color2) {
  * @brief Get color histogram of a cell.
  * The histogram contains the percentage of pixels from each "magic" unique color.
  * It turns that this color histogram of unique colors has a one-to-one mapping to cell type.
+ * @param histogram Color histogram to fill (NUMBER_OF_COLORS values).
  * @param cell The cell.
  * @param screenshot_data Struct containing screenshot and size.
- * @return Cell's color histogram of unique constant colors.
+ * @return Void.
  */
-t_color_histogram get_cell_color_histogram(t_board_cell cell, t_screenshot_data *screenshot_data) {
-    t_color_histogram histogram = (t_color_histogram) malloc(NUMBER_OF_COLORS * sizeof(double));
+void get_cell_color_histogram(t_color_histogram histogram, t_board_cell cell, t_screenshot_data *screenshot_data) {
     for (int i = 0; i < NUMBER_OF_COLORS; i++)
         histogram[i] = 0;
     t_cell_rect cell_rect = get_cell_rect(cell);
@@ -155,7 +157,6 @@ t_color_histogram get_cell_color_histogram(t_board_cell cell, t_screenshot_data
         }
     for (int j = 0; j < NUMBER_OF_COLORS; j++)
         histogram[j] /= (double) ((cell_rect.x_max - cell_rect.x_min) * (cell_rect.y_max - cell_rect.y_min));
-    return histogram;
 }
 
 /**
@@ -200,40 +201,42 @@ t_cell_type predict_by_color_distribution(const t_color_histogram histogram) {
 
 /**
  * @brief Get cell type from screenshot.
+ * @param solver Solver context (owns the color histogram scratch buffer).
  * @param prediction Pointer to predicted cell type.
  * @param cell Cell to predict.
  * @param screenshot_data_ptr Pointer to screenshot data (image and size).
  * @return Error code.
  */
-t_error_code classify_cell(t_cell_type *prediction, t_board_cell cell, t_screenshot_data *screenshot_data_ptr) {
-    t_color_histogram cell_histogram = get_cell_color_histogram(cell, screenshot_data_ptr);
+t_error_code classify_cell(t_solver *solver, t_cell_type *prediction, t_board_cell cell,
+                           t_screenshot_data *screenshot_data_ptr) {
+    t_color_histogram cell_histogram = solver->color_histogram;
+    get_cell_color_histogram(cell_histogram, cell, screenshot_data_ptr);
     t_error_code error_code = log_histogram(cell, cell_histogram);
     if (error_code)
         return error_code;
     if (predict_by_unique_color(cell_histogram, prediction))
-        goto lblCleanup;
+        return RETURN_CODE_SUCCESS;
     *prediction = predict_by_color_distribution(cell_histogram);
-    lblCleanup:
-    free(cell_histogram);
     return RETURN_CODE_SUCCESS;
 }
 
 /**
  * @brief Set board cells according to screenshot.
+ * @param solver Solver context.
  * @param board Board to set.
  * @param screenshot_data_ptr Pointer to minesweeper window screenshot (image and size).
  * @return Error code.
  */
-t_error_code set_board(t_board board, t_screenshot_data *screenshot_data_ptr) {
-    for (int row = 0; row < board_size.rows; row++)
-        for (int col = 0; col < board_size.cols; col++) {
+t_error_code set_board(t_solver *solver, t_board board, t_screenshot_data *screenshot_data_ptr) {
+    for (int row = 0; row < board.size.rows; row++)
+        for (int col = 0; col < board.size.cols; col++) {
             t_board_cell cell = {row, col};
             if (BOARD_CELL(board, row, col) == UNKNOWN_CELL) {
                 t_cell_type cell_prediction = UNKNOWN_CELL;
-                t_error_code error_code = classify_cell(&cell_prediction, cell, screenshot_data_ptr);
+                t_error_code error_code = classify_cell(solver, &cell_prediction, cell, screenshot_data_ptr);
                 if (error_code)
                     return error_code;
-                BOARD_CELL(board, row, col) = cell_prediction;
+                set_board_cell(board, row, col, cell_prediction);
             }
         }
     return RETURN_CODE_SUCCESS;
@@ -272,7 +275,8 @@ update_game_status(t_game_status *game_status, t_screenshot_data *screenshot_dat
     return RETURN_CODE_SUCCESS;
 }
 
-t_error_code update_board(t_board board, t_game_status *game_status, t_cell_rect game_status_rect) {
+t_error_code update_board(t_solver *solver, t_board board, t_game_status *game_status,
+                          t_cell_rect game_status_rect) {
     t_screenshot_data screenshot_data = {0, 0, NULL};
     t_error_code error_code = RETURN_CODE_SUCCESS;
     error_code = get_minesweeper_screenshot(&screenshot_data);
@@ -281,7 +285,7 @@ t_error_code update_board(t_board board, t_game_status *game_status, t_cell_rect
     error_code = update_game_status(game_status, &screenshot_data, game_status_rect);
     if (*game_status != GAME_ON || error_code)
         goto lblCleanup;
-    error_code = set_board(board, &screenshot_data);
+    error_code = set_board(solver, board, &screenshot_data);
     if (error_code)
         goto lblCleanup;
     error_code = log_board(board);
@@ -9,8 +9,12 @@
 #define MINESWEEPERSOLVER_BOARD_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "error_codes.h"
 
+#define NUMBER_PLANES_NUMBER 4  // Bit-slices of cell numbers (0 to 8).
+
 /**
  * Enum for board cell types.
  */
@@ -77,26 +81,58 @@ struct board_cell {
 
 typedef struct board_size t_board_size;
 typedef struct board_cell t_board_cell;
-typedef t_cell_type *t_board;
 typedef struct cell_rect t_cell_rect;
 typedef double *t_color_histogram;
 
+/**
+ * Enum for board bitplanes, every plane has a bit for every cell, in rows of 64-bit words.
+ * Cell numbers are bit-sliced, bit i of the number of a revealed cell is in plane NUMBER_PLANE + i.
+ */
+typedef enum {
+    UNKNOWN_PLANE,
+    MINE_PLANE,
+    REVEALED_PLANE,
+    NUMBER_PLANE,
+    BOARD_PLANES_NUMBER = NUMBER_PLANE + NUMBER_PLANES_NUMBER
+} t_board_plane;
+
+/**
+ * Struct for board, heap allocated cells, their bitplanes and board size.
+ * Cells must be set with set_board_cell, to keep bitplanes (and changed words) in sync.
+ */
+struct board {
+    t_cell_type *cells;
+    t_board_size size;
+    int words_per_row;  // Length of a bitplane row, in 64-bit words.
+    uint64_t *planes;   // BOARD_PLANES_NUMBER bitplanes, bits beyond the last column are always clear.
+    uint64_t *changed_words; // Bit of every plane word (row-major) set since the solver last read it, may be NULL.
+};
+typedef struct board t_board;
+
 /**
  * Macro for accessing board cell.
  */
-#define BOARD_CELL(board, x_index, y_index) board[x_index * board_size.cols + y_index]
+#define BOARD_CELL(board, x_index, y_index) (board).cells[(x_index) * (board).size.cols + (y_index)]
+
+/**
+ * Macro for accessing a row of board bitplane.
+ */
+#define BOARD_PLANE_ROW(board, plane, row) \
+    ((board).planes + ((size_t) (plane) * (board).size.rows + (row)) * (board).words_per_row)
 
-extern t_board_size board_size;
+struct solver;
 
 /**
  * @brief Update board state (cells) and status (smiley state).
  * The used technique is image processing over Minesweeper window screenshot.
  * For further details of implementation read board module.
+ * @param solver Solver context.
  * @param board The board.
  * @param game_status Pointer for game status to update.
  * @param game_status_rect Pixels indexes rectangle for smiley (in window coordinates).
  * @return Error code.
  */
-t_error_code update_board(t_board board, t_game_status *game_status, t_cell_rect game_status_rect);
+t_error_code update_board(struct solver *solver, t_board board, t_game_status *game_status,
+                          t_cell_rect game_status_rect);
 
 #endif //MINESWEEPERSOLVER_BOARD_H
@@ -5,185 +5,39 @@
  * @date 25.5.2020
  * @brief board_analyzer module is responsible for choosing
  * the moves for a given board state.
- * The used technique is creating a linear matrix for all unknown cells,
- * and finding all deterministic variables using Gaussian elimination.
- * Once a guess is required, a probability-based heuristic is used.
+ * Cells that follow from a single changed equation (local rules) are returned first. Otherwise,
+ * the used technique is creating linear equations for all unknown cells with numeric neighbors,
+ * splitting them into independent components, and finding all deterministic variables
+ * of every component using exact integer Gaussian elimination (over a small matrix of the component).
+ * Once a guess is required, the exact mine probability of every unknown cell is computed,
+ * and the cell with the lowest probability is chosen.
  *************************************************************************************************/
 #include <stdlib.h>
 #include "common.h"
 #include "board.h"
+#include "bitboard.h"
 #include "board_analyzer.h"
 #include "logger.h"
 #include "matrix.h"
+#include "frontier.h"
+#include "local_rules.h"
+#include "reduction.h"
+#include "sparse_matrix.h"
+#include "probability.h"
+#include "component_cache.h"
+#include "endgame.h"
+#include "solver.h"
+#include "timer.h"
 
-#define NEIGHBORS_NUMBER 8
-#define VARIABLES_MAP_NULL -1.0
-#define VARIABLES_MAP_MINE -2.0
-#define VARIABLES_MAP_CLEAR -3.0
+#define DEDUCTION_CLEAR 0
+#define DEDUCTION_MINE 1
 /**
- * Macro for whether a cell marked in variable table is a deterministic clear of mine.
+ * Macro for whether a variable deduction is a deterministic clear or mine.
  */
-#define IS_DETERMINISTIC(x) (x == VARIABLES_MAP_MINE || x == VARIABLES_MAP_CLEAR)
-/**
- * Macro for all neighbor cells of a cell
- */
-#define NEIGHBOR_CELLS(cell) {{cell.row - 1, cell.col - 1},   \
-                                {cell.row - 1, cell.col},     \
-                                {cell.row - 1, cell.col + 1}, \
-                                {cell.row, cell.col - 1},     \
-                                {cell.row, cell.col + 1},     \
-                                {cell.row + 1, cell.col - 1}, \
-                                {cell.row + 1, cell.col},     \
-                                {cell.row + 1, cell.col + 1}} \
-
-struct neighbors_data {
-    int unknowns;
-    int mines;
-};
-
-typedef struct neighbors_data t_neighbors_data;
-
-/**
- * @brief Is a cell in board containing a numeric value.
- * @param board The board.
- * @param cell The cell.
- * @return Boolean, true if cell is not unknown or a mine, false otherwise.
- */
-bool is_numeric_cell(t_board board, t_board_cell cell) {
-    t_cell_type cell_value = BOARD_CELL(board, cell.row, cell.col);
-    return cell_value != MINE && cell_value != UNKNOWN_CELL;
-}
-
-/**
- * @brief Get the probability of cell with no neighbors information to be clear.
- * This is the number of missing mines divided by the number of unknown cells left.
- * @param total_number_of_mines Number of mines in this Minesweeper level.
- * @param board The board.
- * @param Matrix The matrix.
- * @return Probability of uniform cell to be clear in current state.
- */
-double get_isolated_clear_probability(int total_number_of_mines, t_board board, t_matrix matrix) {
-    int detected_mines_counter = 0;
-    int unknown_cells_counter = 0;
-    for (int row = 0; row < board_size.rows; row++)
-        for (int col = 0; col < board_size.cols; col++) {
-            if (BOARD_CELL(board, row, col) == MINE)
-                detected_mines_counter++;
-            if (BOARD_CELL(board, row, col) == UNKNOWN_CELL)
-                unknown_cells_counter++;
-        }
-    int number_of_isolated_unknowns = unknown_cells_counter - (matrix.size.cols - 1);
-    if (number_of_isolated_unknowns <= 0)
-        return 0;
-    return 1 - ((double) (total_number_of_mines - detected_mines_counter) /
-                (double) (unknown_cells_counter));
-}
-
-/**
- * @brief Is a cell in board range.
- * @param cell Cell to check.
- * @return Boolean, true if cell is in the board boarders, false otherwise.
- */
-bool is_cell_in_board(t_board_cell cell) {
-    if (cell.row >= board_size.rows || cell.row < 0)
-        return false;
-    if (cell.col >= board_size.cols || cell.col < 0)
-        return false;
-    return true;
-}
-
-/**
- * @brief Get neighbors data of a cell (number of neighbor unknowns and mines).
- * @param board The board.
- * @param neighbor_cells Array of the neighbor cells.
- * @return Neighbors data (number of mines and unknowns neighbors in a struct).
- */
-t_neighbors_data get_neighbors_data(t_board board, t_board_cell neighbor_cells[]) {
-    int unknown_counter = 0, mine_counter = 0;
-    for (int k = 0; k < NEIGHBORS_NUMBER; k++)
-        if (is_cell_in_board(neighbor_cells[k])) {
-            t_cell_type cell_value = BOARD_CELL(board, neighbor_cells[k].row, neighbor_cells[k].col);
-            if (cell_value == MINE)
-                mine_counter++;
-            else if (cell_value == UNKNOWN_CELL)
-                unknown_counter++;
-        }
-    t_neighbors_data neighbors_data = {unknown_counter, mine_counter};
-    return neighbors_data;
-}
-
-/**
- * @brief Calculate (pre-creation) the matrix size of the linear unknown cells equations matrix.
- * @param board The board.
- * @param matrix_size Pointer to matrix size.
- * @return Error code.
- */
-t_error_code get_equations_matrix_size(t_board board, t_matrix_size *matrix_size) {
-    matrix_size->rows = 0;
-    matrix_size->cols = 1;
-    t_matrix is_cell_variable_marked = initialize_matrix(board_size, false);
-    if (!is_cell_variable_marked.data)
-        return ERROR_INITIALIZE_MATRIX_MEMORY_ALLOC;
-    for (int row = 0; row < board_size.rows; row++)
-        for (int col = 0; col < board_size.cols; col++) {
-            t_board_cell cell = {row, col};
-            bool is_cell_equation = false;
-            if (!is_numeric_cell(board, cell))
-                continue;
-            t_board_cell neighbor_cells[] = NEIGHBOR_CELLS(cell);
-            for (int k = 0; k < NEIGHBORS_NUMBER; k++) {
-                if (is_cell_in_board(neighbor_cells[k])
-                    && BOARD_CELL(board, neighbor_cells[k].row, neighbor_cells[k].col) == UNKNOWN_CELL) {
-                    is_cell_equation = true;
-                    if (MATRIX_CELL(is_cell_variable_marked, neighbor_cells[k].row, neighbor_cells[k].col) == false) {
-                        MATRIX_CELL(is_cell_variable_marked, neighbor_cells[k].row, neighbor_cells[k].col) = true;
-                        matrix_size->cols += 1;
-                    }
-                }
-            }
-            if (is_cell_equation)
-                matrix_size->rows += 1;
-        }
-    free(is_cell_variable_marked.data);
-    return RETURN_CODE_SUCCESS;
-}
-
-/**
- * @brief Extract board cell from variable index, using the variables mapping.
- * @param variable_number Index of variable to extract.
- * @param variables_map Mapping between board to variable indexes.
- * @return Board cell that is represented by the variable index.
- */
-t_board_cell extract_board_cell(int variable_number, t_matrix variables_map) {
-    t_board_cell cell = {0, 0};
-    for (int row = 0; row < board_size.rows; row++) {
-        for (int col = 0; col < board_size.cols; col++) {
-            if ((int) MATRIX_CELL(variables_map, row, col) == variable_number) {
-                cell.row = row;
-                cell.col = col;
-                goto lblReturn;
-            }
-        }
-    }
-    lblReturn:
-    ASSERT(BOARD_CELL(variables_map, cell.row, cell.col) == variable_number);
-    return cell;
-}
-
-/**
- * @brief Is a matrix row contains only non-negative values.
- * This condition is required to evaluate probability of a given cell to be clear.
- * @param matrix The matrix.
- * @param row Row index.
- * @return Boolean, true if row contains only non-negative values, false otherwise.
- */
-bool is_informative_row(t_matrix matrix, int row) {
-    for (int col = 0; col < matrix.size.cols - 1; col++) {
-        if (MATRIX_CELL(matrix, row, col) < 0)
-            return false;
-    }
-    return true;
-}
+#define IS_DETERMINISTIC(x) ((x) != DEDUCTION_UNDECIDED)
+#define PROBABILITY_EPSILON 1e-12
+#define PROBABILITY_CONFIDENCE_Z 1.0    // Standard errors added to sampled probabilities when guessing.
+#define ANALYZER_MIN_PARALLEL_VARIABLES 64 // Smaller frontiers are eliminated on the calling thread alone.
 
 /**
  * @brief Zero all cells of a variable by subtracting the variables value from bias.
@@ -195,41 +49,39 @@ bool is_informative_row(t_matrix matrix, int row) {
  * @param variable_value The variable value.
  * @return Void.
  */
-void zero_variable_in_all_next_equations(t_matrix matrix, int col, int row, double variable_value) {
+void zero_variable_in_all_next_equations(t_integer_matrix matrix, int col, int row, int variable_value) {
     for (int equation = row - 1; equation >= 0; equation--) {
-        if (MATRIX_CELL(matrix, equation, col) != 0) {
+        if (INTEGER_MATRIX_CELL(matrix, equation, col) != 0) {
             if (variable_value != 0)
-                MATRIX_CELL(matrix, equation, matrix.size.cols - 1) -= MATRIX_CELL(matrix, equation, col);
-            MATRIX_CELL(matrix, equation, col) = 0;
+                INTEGER_MATRIX_CELL(matrix, equation, matrix.size.cols - 1) -= INTEGER_MATRIX_CELL(matrix, equation, col);
+            INTEGER_MATRIX_CELL(matrix, equation, col) = 0;
         }
     }
 }
 
 /**
  * @brief Extract all deterministic variables values from a equations matrix row.
- * @param variables_map Mapping between cells and variable indexes.
+ * @param deductions Deduction of every matrix column variable.
  * @param matrix The equations matrix.
- * @param deterministic_map Matrix of cell detections (in the size of board).
  * @param row The row index.
  * @param is_upper_bound Boolean, true if row meets it's upper bound, false if it meets it's lower bound.
  * @return Number of variables that their value has been discovered.
  */
-int extract_partial_solution_from_row(t_matrix variables_map, t_matrix matrix, t_matrix deterministic_map,
-                                      int row, bool is_upper_bound) {
+int extract_partial_solution_from_row(signed char *deductions, t_integer_matrix matrix, int row,
+                                      bool is_upper_bound) {
     int marked_variables = 0;
     for (int col = 0; col < matrix.size.cols - 1; col++) {
-        t_board_cell board_cell = extract_board_cell(col, variables_map);
-        if (IS_DETERMINISTIC(MATRIX_CELL(deterministic_map, board_cell.row, board_cell.col)))
+        if (IS_DETERMINISTIC(deductions[col]))
             continue;
-        bool is_mine = (MATRIX_CELL(matrix, row, col) > 0 && is_upper_bound) ||
-                       (MATRIX_CELL(matrix, row, col) < 0 && !is_upper_bound);
-        bool is_clear = (MATRIX_CELL(matrix, row, col) > 0 && !is_upper_bound) ||
-                        (MATRIX_CELL(matrix, row, col) < 0 && is_upper_bound);
+        bool is_mine = (INTEGER_MATRIX_CELL(matrix, row, col) > 0 && is_upper_bound) ||
+                       (INTEGER_MATRIX_CELL(matrix, row, col) < 0 && !is_upper_bound);
+        bool is_clear = (INTEGER_MATRIX_CELL(matrix, row, col) > 0 && !is_upper_bound) ||
+                        (INTEGER_MATRIX_CELL(matrix, row, col) < 0 && is_upper_bound);
         if (is_mine) {
-            MATRIX_CELL(deterministic_map, board_cell.row, board_cell.col) = VARIABLES_MAP_MINE;
+            deductions[col] = DEDUCTION_MINE;
             zero_variable_in_all_next_equations(matrix, col, row, 1);
         } else if (is_clear) {
-            MATRIX_CELL(deterministic_map, board_cell.row, board_cell.col) = VARIABLES_MAP_CLEAR;
+            deductions[col] = DEDUCTION_CLEAR;
             zero_variable_in_all_next_equations(matrix, col, row, 0);
         }
         if (is_mine || is_clear)
@@ -244,115 +96,285 @@ int extract_partial_solution_from_row(t_matrix variables_map, t_matrix matrix, t
  * For every line if bias meets lower or upper bound of row (for 1-0 values), variables have solution.
  * In that case, we extract all variables deterministic values, and delete the variable from later equations.
  * @param matrix Unknown cells equations matrix.
- * @param variables_map Mapping between board cells and variables indexes.
- * @param deterministic_map Matrix of cell detections (in the size of board).
+ * @param deductions Deduction of every matrix column variable.
  * @return Number of deterministic cells that detected.
  */
-int mark_deterministic_cells(t_matrix matrix, t_matrix variables_map,
-                             t_matrix deterministic_map) {
+int mark_deterministic_cells(t_integer_matrix matrix, signed char *deductions) {
     int deterministic_cells = 0;
-    int last_non_zero_row = get_last_non_zero_row(matrix);
+    int last_non_zero_row = get_integer_last_non_zero_row(matrix);
     for (int row = last_non_zero_row; row < matrix.size.rows && row >= 0; row--) {
-        double row_upper_bound = get_row_upper_bound(matrix, row);
-        double row_lower_bound = get_row_lower_bound(matrix, row);
-        double row_bias = MATRIX_CELL(matrix, row, matrix.size.cols - 1);
+        int64_t row_upper_bound = get_integer_row_upper_bound(matrix, row);
+        int64_t row_lower_bound = get_integer_row_lower_bound(matrix, row);
+        int64_t row_bias = INTEGER_MATRIX_CELL(matrix, row, matrix.size.cols - 1);
         if (row_bias == row_lower_bound)
-            deterministic_cells += extract_partial_solution_from_row(variables_map, matrix, deterministic_map, row,
-                                                                     false);
-        else if (row_bias == row_upper_bound) {
-            deterministic_cells += extract_partial_solution_from_row(variables_map, matrix, deterministic_map, row,
-                                                                     true);
-        }
+            deterministic_cells += extract_partial_solution_from_row(deductions, matrix, row, false);
+        else if (row_bias == row_upper_bound)
+            deterministic_cells += extract_partial_solution_from_row(deductions, matrix, row, true);
     }
     return deterministic_cells;
 }
 
 /**
- * @brief Extract deterministic moves out of deterministic cell map.
- * @param deterministic_map Matrix in board size that maps deterministic detected cells.
- * @param number_of_deterministic_cells Number of deterministic cells that detected.
- * @param moves Pointer to moves to update.
+ * @brief Extract deterministic moves out of variables deductions.
+ * @param frontier Pointer to frontier.
+ * @param deductions Deduction of every frontier variable.
+ * @param moves Pointer to moves to append to.
  * @return Void.
  */
-void extract_deterministic_moves(t_matrix deterministic_map, int number_of_deterministic_cells, t_moves *moves) {
-    moves->number_of_moves = number_of_deterministic_cells;
-    moves->moves = (t_move *) malloc(sizeof(t_move) * number_of_deterministic_cells);
-    int current_move = 0;
-    for (int row = 0; row < board_size.rows; row++)
-        for (int col = 0; col < board_size.cols; col++) {
-            t_board_cell cell = {row, col};
-            if (IS_DETERMINISTIC(MATRIX_CELL(deterministic_map, row, col))) {
-                moves->moves[current_move].cell = cell;
-                moves->moves[current_move].is_mine = (MATRIX_CELL(deterministic_map, row, col) == VARIABLES_MAP_MINE);
-                current_move++;
-            }
+void extract_deterministic_moves(t_frontier *frontier, const signed char *deductions, t_moves *moves) {
+    for (int variable = 0; variable < frontier->variables_number; variable++) {
+        if (IS_DETERMINISTIC(deductions[variable])) {
+            moves->moves[moves->number_of_moves].cell = frontier->variables_cells[variable];
+            moves->moves[moves->number_of_moves].is_mine = (deductions[variable] == DEDUCTION_MINE);
+            moves->number_of_moves++;
         }
+    }
 }
 
 /**
- * @brief Fill the unknown cells linear equations matrix.
- * This is done by writing all equations, and returning mapping between variables and board cells.
- * @param board The board.
- * @param matrix Matrix of equations to fill.
- * @return Mapping between board cells to variables indexes (in the shape of a board-size matrix).
+ * @brief Fill the linear equations matrix of a single component.
+ * Matrix column i is the component's variable (first_variable + i), and the last column is the bias.
+ * @param workspace Component workspace (owns equations matrix buffer).
+ * @param equations Component (reduced) equations, component equations number of them.
+ * @param component The component.
+ * @return Integer equations matrix of component, with NULL data on memory allocation failure.
  */
-t_matrix fill_matrix(t_board board, t_matrix matrix) {
-    int variables_counter = 0;
-    int current_equation = 0;
-    t_matrix variables_map = initialize_matrix(board_size, VARIABLES_MAP_NULL);
-    for (int row = 0; row < board_size.rows; row++) {
-        for (int col = 0; col < board_size.cols; col++) {
-            t_board_cell cell = {row, col};
-            if (!is_numeric_cell(board, cell))
-                continue;
-            t_board_cell neighbor_cells[] = NEIGHBOR_CELLS(cell);
-            t_neighbors_data neighbors_data = get_neighbors_data(board, neighbor_cells);
-            if (neighbors_data.unknowns == 0)
+t_integer_matrix fill_component_matrix(t_component_workspace *workspace, const t_equation *equations,
+                                       t_component component) {
+    t_matrix_size matrix_size = {component.equations_number, component.variables_number + 1};
+    t_integer_matrix matrix = get_equations_matrix(workspace, matrix_size, 0);
+    if (!matrix.data)
+        return matrix;
+    for (int row = 0; row < component.equations_number; row++) {
+        const t_equation *equation = &equations[row];
+        for (int k = 0; k < equation->variables_number; k++)
+            INTEGER_MATRIX_CELL(matrix, row, equation->variables[k] - component.first_variable) = 1;
+        INTEGER_MATRIX_CELL(matrix, row, matrix.size.cols - 1) = equation->bias;
+    }
+    return matrix;
+}
+
+/**
+ * @brief Fill the compact linear equations matrix of a single component.
+ * @param workspace Component workspace (owns compact equations matrix buffer).
+ * @param equations Component (reduced) equations, component equations number of them.
+ * @param component The component.
+ * @return Compact equations matrix of component, with NULL data on memory allocation failure.
+ */
+t_compact_matrix fill_compact_component_matrix(t_component_workspace *workspace, const t_equation *equations,
+                                               t_component component) {
+    t_matrix_size matrix_size = {component.equations_number, component.variables_number};
+    t_compact_matrix matrix = get_compact_equations_matrix(workspace, matrix_size);
+    if (!matrix.data)
+        return matrix;
+    for (int row = 0; row < component.equations_number; row++) {
+        const t_equation *equation = &equations[row];
+        for (int k = 0; k < equation->variables_number; k++)
+            COMPACT_MATRIX_CELL(matrix, row, equation->variables[k] - component.first_variable) = 1;
+        matrix.biases[row] = equation->bias;
+    }
+    return matrix;
+}
+
+/**
+ * @brief Is any row of an eliminated compact matrix meeting its lower or upper bound.
+ * If no row does, the component has no deterministic cell.
+ * @param matrix The eliminated compact matrix.
+ * @return Boolean, true if a row meets a bound, false otherwise.
+ */
+bool has_bounded_row(t_compact_matrix matrix) {
+    for (int row = 0; row < matrix.size.rows; row++) {
+        int32_t row_lower_bound, row_upper_bound;
+        get_compact_row_bounds(matrix, row, &row_lower_bound, &row_upper_bound);
+        if (row_upper_bound != row_lower_bound &&
+            (matrix.biases[row] == row_lower_bound || matrix.biases[row] == row_upper_bound))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Mark the cells of reduced equations that are deterministic on their own.
+ * A reduced equation with bias 0 has clear variables, and one with bias equal to its number of variables has mines.
+ * @param equations Reduced equations.
+ * @param equations_number Number of reduced equations.
+ * @param deductions Deduction of every component variable.
+ * @param first_variable First variable of component.
+ * @return Number of newly marked deterministic cells.
+ */
+int mark_reduced_deterministic_cells(const t_equation *equations, int equations_number, signed char *deductions,
+                                     int first_variable) {
+    int deterministic_cells = 0;
+    for (int i = 0; i < equations_number; i++) {
+        const t_equation *equation = &equations[i];
+        if (equation->bias != 0 && equation->bias != equation->variables_number)
+            continue;
+        for (int k = 0; k < equation->variables_number; k++) {
+            signed char *deduction = &deductions[equation->variables[k] - first_variable];
+            if (IS_DETERMINISTIC(*deduction))
                 continue;
-            for (int k = 0; k < NEIGHBORS_NUMBER; k++) {
-                if (is_cell_in_board(neighbor_cells[k]) &&
-                    BOARD_CELL(board, neighbor_cells[k].row, neighbor_cells[k].col) == UNKNOWN_CELL) {
-                    if (MATRIX_CELL(variables_map, neighbor_cells[k].row, neighbor_cells[k].col) ==
-                        VARIABLES_MAP_NULL) {
-                        MATRIX_CELL(variables_map, neighbor_cells[k].row, neighbor_cells[k].col) = variables_counter;
-                        variables_counter++;
-                    }
-                    MATRIX_CELL(matrix, current_equation,
-                                (int) MATRIX_CELL(variables_map, neighbor_cells[k].row, neighbor_cells[k].col)) = 1;
-                }
-            }
-            MATRIX_CELL(matrix, current_equation, matrix.size.cols - 1) =
-                    BOARD_CELL(board, row, col) - neighbors_data.mines;
-            current_equation++;
+            *deduction = (signed char) (equation->bias ? DEDUCTION_MINE : DEDUCTION_CLEAR);
+            deterministic_cells++;
         }
     }
-    return variables_map;
+    return deterministic_cells;
 }
 
 /**
- * @brief Is the board in legal (possible state).
- * This functions verifies that the detected board is in legal state,
- * in order to prevent unexpected states when cell detector failed (failsafe function).
- * Verification is done by having a look over number cells and their number of mine neighbors.
- * @param board The board.
- * @return Boolean, true if board is in legal state, false otherwise.
+ * @brief Mark all deterministic cells of a large sparse component, by sparse elimination.
+ * @param workspace Component workspace (owns sparse matrix).
+ * @param equations Component (reduced) equations, component equations number of them.
+ * @param deductions Deduction of every component variable.
+ * @param component The component.
+ * @param deterministic_cells Pointer to number of deterministic cells to update.
+ * @return Error code.
  */
-bool is_legal_board(t_board board) {
-    for (int row = 0; row < board_size.rows; row++)
-        for (int col = 0; col < board_size.cols; col++) {
-            t_board_cell cell = {row, col};
-            if (is_numeric_cell(board, cell)) {
-                t_board_cell neighbor_cells[] = NEIGHBOR_CELLS(cell);
-                t_neighbors_data neighbors_data = get_neighbors_data(board, neighbor_cells);
-                int cell_number = BOARD_CELL(board, row, col);
-                if (neighbors_data.mines > cell_number ||
-                    cell_number > neighbors_data.mines + neighbors_data.unknowns) {
-                    log_illegal_cell(cell);
-                    return false;
-                }
-            }
+t_error_code solve_sparse_component(t_component_workspace *workspace, const t_equation *equations,
+                                    signed char *deductions, t_component component, int *deterministic_cells) {
+    t_sparse_matrix *matrix = &workspace->sparse_matrix;
+    bool is_eliminated = false;
+    t_error_code error_code = fill_sparse_matrix(matrix, equations, component);
+    if (!error_code)
+        error_code = sparse_gauss_eliminate(matrix, &is_eliminated);
+    // Like dense elimination, a component that overflows elimination gives no deductions.
+    if (error_code || !is_eliminated || deduce_sparse_variables(matrix) == 0)
+        return error_code;
+    for (int variable = 0; variable < component.variables_number; variable++) {
+        if (matrix->values[variable] == SPARSE_UNDECIDED)
+            continue;
+        deductions[variable] = (signed char) (matrix->values[variable] ? DEDUCTION_MINE : DEDUCTION_CLEAR);
+        (*deterministic_cells)++;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Mark all deterministic cells of a single component.
+ * Component equations are reduced first (duplicates dropped, nested equations subtracted), and if the reduced
+ * equations deduce cells on their own, no matrix is built. In gcd normalized mode, a large component of low density
+ * is eliminated over a sparse matrix, and others over a compact matrix (SIMD row kernels), whose eliminated rows are
+ * expanded for marking only if one of them meets a bound. Once compact cells overflow, or in Bareiss mode,
+ * elimination runs over an int64 matrix.
+ * @param solver Solver context.
+ * @param workspace Component workspace.
+ * @param component_equations Component equations, component equations number of them.
+ * @param deductions Deduction of every component variable (undecided ones are set if deduced).
+ * @param component The component.
+ * @param deterministic_cells Pointer to number of deterministic cells to update.
+ * @return Error code.
+ */
+t_error_code solve_component_equations(t_solver *solver, t_component_workspace *workspace,
+                                       const t_equation *component_equations, signed char *deductions,
+                                       t_component component, int *deterministic_cells) {
+    component.equations_number = reduce_equations(&workspace->reduction, component_equations, component);
+    const t_equation *equations = workspace->reduction.equations;
+    int reduced_deterministic_cells = mark_reduced_deterministic_cells(equations, component.equations_number,
+                                                                       deductions, component.first_variable);
+    *deterministic_cells += reduced_deterministic_cells;
+    if (reduced_deterministic_cells > 0)
+        return RETURN_CODE_SUCCESS;
+    if (solver->elimination_mode == ELIMINATION_GCD_NORMALIZED && is_sparse_component(equations, component))
+        return solve_sparse_component(workspace, equations, deductions, component, deterministic_cells);
+    if (solver->elimination_mode == ELIMINATION_GCD_NORMALIZED) {
+        t_compact_matrix compact_matrix = fill_compact_component_matrix(workspace, equations, component);
+        if (!compact_matrix.data)
+            return ERROR_INITIALIZE_MATRIX_MEMORY_ALLOC;
+        if (compact_gauss_eliminate(compact_matrix)) {
+            if (!has_bounded_row(compact_matrix))
+                return RETURN_CODE_SUCCESS;
+            t_matrix_size matrix_size = {component.equations_number, component.variables_number + 1};
+            t_integer_matrix matrix = get_equations_matrix(workspace, matrix_size, 0);
+            if (!matrix.data)
+                return ERROR_INITIALIZE_MATRIX_MEMORY_ALLOC;
+            expand_compact_matrix(compact_matrix, matrix);
+            t_error_code error_code = log_integer_matrix(matrix, "Matrix after compact elimination");
+            if (error_code)
+                return error_code;
+            *deterministic_cells += mark_deterministic_cells(matrix, deductions);
+            return RETURN_CODE_SUCCESS;
         }
-    return true;
+    }
+    t_integer_matrix matrix = fill_component_matrix(workspace, equations, component);
+    if (!matrix.data)
+        return ERROR_INITIALIZE_MATRIX_MEMORY_ALLOC;
+    // A component that overflows elimination gives no deductions, its guess probabilities are still exact.
+    if (!integer_gauss_eliminate(matrix, solver->elimination_mode))
+        return RETURN_CODE_SUCCESS;
+    *deterministic_cells += mark_deterministic_cells(matrix, deductions);
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Mark all deterministic cells of a single component, by the component cache when possible.
+ * A cacheable component is solved over its canonical equations (so its deductions don't depend on the board order
+ * of its copy), and its deductions are kept in the cache, so the next copy of it is marked without solving.
+ * @param solver Solver context.
+ * @param workspace Component workspace.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @param deterministic_cells Pointer to number of deterministic cells to update.
+ * @return Error code.
+ */
+t_error_code solve_component(t_solver *solver, t_component_workspace *workspace, t_frontier *frontier,
+                             t_component component, int *deterministic_cells) {
+    t_component_cache *cache = &solver->component_cache;
+    t_component_key *key = &workspace->component_key;
+    signed char *component_deductions = solver->variables_deductions + component.first_variable;
+    signed char deductions[COMPONENT_CACHE_MAX_VARIABLES];
+    if (!key_component(cache, key, frontier, component))
+        return solve_component_equations(solver, workspace, frontier->equations + component.first_equation,
+                                         component_deductions, component, deterministic_cells);
+    lock_component_cache(cache);
+    t_component_entry *entry = find_component_entry(cache, key);
+    bool is_cached = entry && entry->is_deduced;
+    for (int i = 0; is_cached && i < component.variables_number; i++)
+        deductions[i] = entry->deductions[i];
+    unlock_component_cache(cache);
+    if (!is_cached) {
+        int component_cells = 0;
+        for (int i = 0; i < component.variables_number; i++)
+            deductions[i] = DEDUCTION_UNDECIDED;
+        t_error_code error_code = solve_component_equations(solver, workspace, key->equations, deductions, component,
+                                                            &component_cells);
+        if (error_code)
+            return error_code;
+        lock_component_cache(cache);
+        entry = store_component_entry(cache, key);
+        for (int i = 0; i < component.variables_number; i++)
+            entry->deductions[i] = deductions[i];
+        entry->is_deduced = true;
+        unlock_component_cache(cache);
+    }
+    for (int i = 0; i < component.variables_number; i++) {
+        if (!IS_DETERMINISTIC(deductions[i]))
+            continue;
+        component_deductions[key->canonical_variables[i]] = deductions[i];
+        (*deterministic_cells)++;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Solve a single pending component (a pool task), into its component result.
+ * Components share no variable, so every task sets only the deductions of its own variables.
+ * @param solver_ptr Pointer to solver context.
+ * @param c Component index.
+ * @param worker_index Index of running worker, selects its workspace.
+ * @return Void.
+ */
+void solve_component_task(void *solver_ptr, int c, int worker_index) {
+    t_solver *solver = (t_solver *) solver_ptr;
+    t_frontier *frontier = &solver->frontier;
+    t_component_result *result = &solver->component_results[c];
+    result->deterministic_cells = 0;
+    result->error_code = RETURN_CODE_SUCCESS;
+    result->is_solved = false;
+    // A settled component has unchanged equations, and its deductions were all returned (and played) before.
+    if (!frontier->components[c].is_pending || is_deadline_passed(solver->turn_deadline))
+        return;
+    result->error_code = solve_component(solver, &solver->workspaces[worker_index], frontier, frontier->components[c],
+                                         &result->deterministic_cells);
+    result->is_solved = !result->error_code;
 }
 
 /**
@@ -364,135 +386,432 @@ bool is_legal_board(t_board board) {
  * @return Void.
  */
 void update_board_by_moves(t_board board, t_moves moves) {
-    for (int i = 0; i < moves.number_of_moves; i++) {
+    for (size_t i = 0; i < moves.number_of_moves; i++) {
         t_move move = moves.moves[i];
         if (move.is_mine)
-            BOARD_CELL(board, move.cell.row, move.cell.col) = MINE;
+            set_board_cell(board, move.cell.row, move.cell.col, MINE);
     }
 }
 
 /**
- * @brief Get random isolated cell, that doesn't appear as matrix variable.
- * @param board The board.
- * @param variables_map Mapping between board cells and matrix variables.
- * @return Random board cell that doesn't appear as matrix variable.
+ * @brief Compare two moves by their cells board order (for qsort).
+ * @param first Pointer to first move.
+ * @param second Pointer to second move.
+ * @return Negative, zero or positive, as first cell comes before, is, or comes after second cell.
  */
-t_board_cell get_random_isolated_cell(t_board board, t_matrix variables_map) {
-    t_board_cell random_isolated_cell = {0, 0};
-    int isolated_cells_number = 0;
-    int random_isolated_index = 0;
-    int index_counter = 0;
-    for (int row = 0; row < board_size.rows; row++)
-        for (int col = 0; col < board_size.cols; col++) {
-            if (BOARD_CELL(board, row, col) == UNKNOWN_CELL &&
-                MATRIX_CELL(variables_map, row, col) == VARIABLES_MAP_NULL)
-                isolated_cells_number++;
-        }
-    ASSERT(isolated_cells_number != 0);
-    random_isolated_index = (rand() % isolated_cells_number);
-    for (int row = 0; row < board_size.rows; row++)
-        for (int col = 0; col < board_size.cols; col++) {
-            if (BOARD_CELL(board, row, col) == UNKNOWN_CELL &&
-                MATRIX_CELL(variables_map, row, col) == VARIABLES_MAP_NULL) {
-                if (index_counter == random_isolated_index) {
-                    random_isolated_cell.row = row;
-                    random_isolated_cell.col = col;
-                    goto lblReturn;
-                }
-                index_counter++;
-            }
-        }
-    lblReturn:
-    return random_isolated_cell;
+int compare_moves_cells(const void *first, const void *second) {
+    t_board_cell first_cell = ((const t_move *) first)->cell, second_cell = ((const t_move *) second)->cell;
+    if (first_cell.row != second_cell.row)
+        return first_cell.row < second_cell.row ? -1 : 1;
+    return (first_cell.col > second_cell.col) - (first_cell.col < second_cell.col);
 }
 
 /**
- * @brief Get the best guess of cell to be clear, from cells that are variables.
- * This search is from all unknown cells that are in the matrix, which means they have numeric neighbors.
- * @param best_variable_clear Pointer to best guess clear variable.
- * @param matrix The unknown cells equations matrix.
- * @param variables_map Mapping between board cells and variable indexes.
- * @return Estimated probability of chosen variable cell to be clear.
+ * @brief Append the moves of all unknown cells whose mine probability is exactly 0 (or 1, if mines are included).
+ * Frontier variables have their own probabilities, and isolated cells share a single one, so they are visited only
+ * if it is deterministic. Appended moves are sorted in board order.
+ * @param solver Solver context, after mine probabilities are computed.
+ * @param is_mines_included Whether cells with a mine probability of 1 are appended (as mines).
+ * @param moves Pointer to moves to append to.
+ * @return Number of appended moves.
  */
-double get_best_clear_variable(t_board_cell *best_variable_clear, t_matrix matrix, t_matrix variables_map) {
-    double maximal_clear_probability = 0;
-    for (int row = 0; row < get_last_non_zero_row(matrix); row++) {
-        double row_sum = get_row_sum(matrix, row);
-        if (row_sum == 0 || !is_informative_row(matrix, row))
+int append_probability_moves(t_solver *solver, bool is_mines_included, t_moves *moves) {
+    t_frontier *frontier = &solver->frontier;
+    t_probability_engine *engine = &solver->probability_engine;
+    t_board known_board = frontier->known_board;
+    size_t first_move = moves->number_of_moves;
+    double isolated_probability = engine->isolated_probability;
+    for (int variable = 0; variable < frontier->variables_number; variable++) {
+        double mine_probability = engine->variables_probabilities[variable];
+        if (mine_probability != 0 && (mine_probability != 1 || !is_mines_included))
             continue;
-        double equation_clear_probability = 1 - (MATRIX_CELL(matrix, row, matrix.size.cols - 1) / row_sum);
-        if (equation_clear_probability > maximal_clear_probability) {
-            maximal_clear_probability = equation_clear_probability;
-            int random_variable_index = (rand() % (int) row_sum);
-            int variable_counter = 0;
-            for (int col = 0; col < matrix.size.cols - 1; col++) {
-                if (MATRIX_CELL(matrix, row, col) != 0) {
-                    if (random_variable_index == variable_counter) {
-                        *best_variable_clear = extract_board_cell(col, variables_map);
-                        goto lblReturn;
-                    }
-                    variable_counter++;
+        moves->moves[moves->number_of_moves].cell = frontier->variables_cells[variable];
+        moves->moves[moves->number_of_moves].is_mine = (mine_probability == 1);
+        moves->number_of_moves++;
+    }
+    if (frontier->unknown_cells > frontier->variables_number &&
+        (isolated_probability == 0 || (isolated_probability == 1 && is_mines_included)))
+        for (int row = 0; row < known_board.size.rows; row++)
+            for (int word = 0; word < known_board.words_per_row; word++)
+                for (uint64_t cells = get_isolated_cells(frontier, row, word); cells; cells &= cells - 1) {
+                    t_board_cell cell = {row, word * BITBOARD_WORD_BITS + get_lowest_bit_index(cells)};
+                    moves->moves[moves->number_of_moves].cell = cell;
+                    moves->moves[moves->number_of_moves].is_mine = (isolated_probability == 1);
+                    moves->number_of_moves++;
                 }
+    qsort(moves->moves + first_move, moves->number_of_moves - first_move, sizeof(t_move), compare_moves_cells);
+    return (int) (moves->number_of_moves - first_move);
+}
+
+/**
+ * @brief Get the guess probability of a frontier variable.
+ * Sampled probabilities are compared by their upper confidence bound, so a cell that looks safe only by few samples
+ * is not preferred over a cell that is known to be nearly as safe.
+ * @param engine Pointer to probability engine, after mine probabilities are computed.
+ * @param variable Variable index.
+ * @return Guess probability.
+ */
+double get_guess_probability(const t_probability_engine *engine, int variable) {
+    return engine->variables_probabilities[variable] + PROBABILITY_CONFIDENCE_Z * engine->variables_errors[variable];
+}
+
+/**
+ * @brief Get an isolated cell by its index in board order.
+ * @param frontier Pointer to laid out frontier.
+ * @param isolated_index Index of isolated cell (less than the number of isolated cells).
+ * @return The isolated cell.
+ */
+t_board_cell get_isolated_cell(t_frontier *frontier, int isolated_index) {
+    t_board known_board = frontier->known_board;
+    t_board_cell cell = {0, 0};
+    for (int row = 0; row < known_board.size.rows; row++)
+        for (int word = 0; word < known_board.words_per_row; word++) {
+            uint64_t cells = get_isolated_cells(frontier, row, word);
+            int cells_number = POPCOUNT64(cells);
+            if (isolated_index >= cells_number) {
+                isolated_index -= cells_number;
+                continue;
             }
+            for (; isolated_index > 0; isolated_index--)
+                cells &= cells - 1;
+            cell.row = row;
+            cell.col = word * BITBOARD_WORD_BITS + get_lowest_bit_index(cells);
+            return cell;
         }
+    return cell;
+}
+
+/**
+ * @brief Get the unknown cell with the lowest mine probability.
+ * Variables are compared by their guess probability, and isolated cells share a single probability. Ties (up to
+ * PROBABILITY_EPSILON of the lowest probability) are broken uniformly at random by a single draw, and a drawn isolated
+ * cell is found by counting isolated cells a word at a time, so a guess costs no board-size scan of cells.
+ * @param solver Solver context, after mine probabilities are computed (or estimated).
+ * @return The safest cell.
+ */
+t_board_cell get_safest_cell(t_solver *solver) {
+    t_frontier *frontier = &solver->frontier;
+    t_probability_engine *engine = &solver->probability_engine;
+    int isolated_cells = frontier->unknown_cells - frontier->variables_number;
+    double lowest_probability = isolated_cells > 0 ? engine->isolated_probability : 2;
+    int tied_variables = 0, tied_cells;
+    for (int variable = 0; variable < frontier->variables_number; variable++)
+        if (get_guess_probability(engine, variable) < lowest_probability)
+            lowest_probability = get_guess_probability(engine, variable);
+    for (int variable = 0; variable < frontier->variables_number; variable++)
+        tied_variables += get_guess_probability(engine, variable) <= lowest_probability + PROBABILITY_EPSILON;
+    tied_cells = tied_variables;
+    if (isolated_cells > 0 && engine->isolated_probability <= lowest_probability + PROBABILITY_EPSILON)
+        tied_cells += isolated_cells;
+    if (tied_cells == 0) {
+        t_board_cell no_cell = {0, 0};
+        return no_cell;
     }
-    lblReturn:
-    return maximal_clear_probability;
+    int tied_index = get_random_index(&solver->random_generator, tied_cells);
+    if (tied_index >= tied_variables)
+        return get_isolated_cell(frontier, tied_index - tied_variables);
+    for (int variable = 0;; variable++)
+        if (get_guess_probability(engine, variable) <= lowest_probability + PROBABILITY_EPSILON &&
+            tied_index-- == 0)
+            return frontier->variables_cells[variable];
 }
 
 /**
  * @brief Make the best guess of a cell (as a clear cell).
- * This function is called once no deterministic cell (mine or clear) is detected.
- * @param board The board.
- * @param moves Next moves pointer.
- * @param variables_map Mapping between cells and variable indexes.
- * @param matrix The unknown cells equations matrix.
- * @param total_number_of_mines Number of mines in current Minesweeper level.
+ * This function is called once no deterministic cell (mine or clear) is detected, so the mine probabilities of the
+ * last deduction pass are still valid, and the cell with the lowest probability is chosen.
+ * In the endgame (few unknown cells, with exact probabilities) the cell that maximizes the win probability is chosen
+ * instead, unless its search exceeds its nodes budget (or the turn deadline, or an opt-in time cap).
+ * In case probabilities are exact and some cells have zero probability, all of them are returned as clear moves.
+ * Sampled or estimated probabilities of zero don't prove a cell safe, so such a cell is only the safest guess.
+ * @param solver Solver context.
+ * @param moves Pointer to (empty) moves to append to.
  * @return Void.
  */
-void make_best_guess(t_board board, t_moves *moves, t_matrix variables_map,
-                     t_matrix matrix, int total_number_of_mines) {
-    t_board_cell best_variable_cell = {0, 0};
-    t_move *bet_clear_move = (t_move *) malloc(sizeof(t_move));
-    double isolated_clear_probability = get_isolated_clear_probability(total_number_of_mines, board, matrix);
-    double variable_clear_probability = get_best_clear_variable(&best_variable_cell, matrix, variables_map);
-    if (variable_clear_probability >= isolated_clear_probability)
-        bet_clear_move->cell = best_variable_cell;
+void make_best_guess(t_solver *solver, t_moves *moves) {
+    t_frontier *frontier = &solver->frontier;
+    uint64_t endgame_deadline = solver->turn_deadline;
+    if (solver->endgame_time_budget > 0) {
+        uint64_t time_cap = get_deadline(solver->endgame_time_budget);
+        endgame_deadline = time_cap < endgame_deadline ? time_cap : endgame_deadline;
+    }
+    moves->stage = MOVE_STAGE_PROBABILITY;
+    if (solver->probability_engine.is_exact && append_probability_moves(solver, false, moves) > 0)
+        return;
+    if (solver->probability_engine.is_exact && frontier->unknown_cells <= ENDGAME_MAX_CELLS &&
+        solver->endgame_node_budget > 0 && !is_deadline_passed(endgame_deadline) &&
+        solve_endgame(&solver->endgame, frontier, solver->number_of_mines - frontier->flagged_mines,
+                      solver->endgame_node_budget, endgame_deadline, &moves->moves[0].cell))
+        moves->stage = MOVE_STAGE_ENDGAME;
     else
-        bet_clear_move->cell = get_random_isolated_cell(board, variables_map);
-    bet_clear_move->is_mine = false;
-    moves->moves = bet_clear_move;
+        moves->moves[0].cell = get_safest_cell(solver);
+    moves->moves[0].is_mine = false;
     moves->number_of_moves = 1;
+    moves->is_guess = true;
 }
 
-t_error_code get_moves(t_board board, t_moves *moves, int total_number_of_mines) {
-    if (!is_legal_board(board))
-        return ERROR_GET_MOVE_ILLEGAL_BOARD_DETECTED;
-    t_matrix_size matrix_size = {0, 0};
-    t_error_code error_code = get_equations_matrix_size(board, &matrix_size);
-    if (error_code)
+/**
+ * @brief Make a guess by linear time estimates of mine probabilities, once the deadline has passed before they could
+ * be computed.
+ * @param solver Solver context.
+ * @param moves Pointer to (empty) moves to append to.
+ * @return Void.
+ */
+void make_quick_guess(t_solver *solver, t_moves *moves) {
+    estimate_mine_probabilities(&solver->probability_engine, &solver->frontier, solver->number_of_mines);
+    moves->moves[0].cell = get_safest_cell(solver);
+    moves->moves[0].is_mine = false;
+    moves->number_of_moves = 1;
+    moves->is_guess = true;
+    moves->stage = MOVE_STAGE_QUICK_GUESS;
+}
+
+/**
+ * @brief Extract the moves of cells decided by local rules.
+ * @param rules Pointer to local rules, after a pass that decided some cells.
+ * @param board_size Board size.
+ * @param moves Pointer to moves to append to.
+ * @return Void.
+ */
+void extract_local_moves(t_local_rules *rules, t_board_size board_size, t_moves *moves) {
+    for (int i = 0; i < rules->decided_number; i++) {
+        t_board_cell cell = {rules->decided_cells[i] / board_size.cols, rules->decided_cells[i] % board_size.cols};
+        moves->moves[moves->number_of_moves].cell = cell;
+        moves->moves[moves->number_of_moves].is_mine = rules->decided_mines[i];
+        moves->number_of_moves++;
+    }
+}
+
+/**
+ * @brief Deduce cells out of the whole frontier system, once local rules deduce nothing.
+ * Frontier is laid out and split into components, and every pending component is solved by elimination, until
+ * the turn deadline (components that are not solved stay pending). Components are solved as tasks of the solver
+ * thread pool, and their results are merged in component order.
+ * @param solver Solver context.
+ * @param moves Pointer to moves to append deterministic moves to.
+ * @return Error code.
+ */
+t_error_code deduce_frontier_cells(t_solver *solver, t_moves *moves) {
+    t_frontier *frontier = &solver->frontier;
+    int deterministic_cells = 0;
+    lay_out_frontier(frontier);
+    find_components(frontier);
+    log_variables_cells(frontier->variables_cells, frontier->variables_number);
+    for (int variable = 0; variable < frontier->variables_number; variable++)
+        solver->variables_deductions[variable] = DEDUCTION_UNDECIDED;
+    run_pool_tasks(&solver->thread_pool, frontier->components_number,
+                   frontier->variables_number >= ANALYZER_MIN_PARALLEL_VARIABLES, solve_component_task, solver);
+    for (int i = 0; i < frontier->components_number; i++) {
+        t_component_result result = solver->component_results[i];
+        if (result.error_code)
+            return result.error_code;
+        if (!result.is_solved)
+            continue;
+        deterministic_cells += result.deterministic_cells;
+        settle_component(frontier, frontier->components[i]);
+    }
+    if (deterministic_cells > 0) {
+        extract_deterministic_moves(frontier, solver->variables_deductions, moves);
+        moves->stage = MOVE_STAGE_ELIMINATION;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Check whether the global mine count may force any cell of a laid out frontier.
+ * Frontier mines are bounded by the missing mines of the equations (every variable is in some equation), per
+ * component. While the remaining mines exceed this bound and are fewer than the isolated cells, every number of
+ * frontier mines leaves a valid number of isolated mines, and isolated cells are neither all clear nor all mines.
+ * @param frontier Pointer to laid out frontier, after components split.
+ * @param number_of_mines Total number of mines in game.
+ * @return Boolean, true if the mine count may force cells.
+ */
+bool is_mine_count_binding(t_frontier *frontier, int number_of_mines) {
+    int mines_left = number_of_mines - frontier->flagged_mines;
+    int isolated_cells = frontier->unknown_cells - frontier->variables_number;
+    int max_frontier_mines = 0;
+    if (isolated_cells == 0 || mines_left >= isolated_cells)
+        return true;
+    for (int c = 0; c < frontier->components_number; c++) {
+        t_component component = frontier->components[c];
+        int missing_mines = 0;
+        for (int i = 0; i < component.equations_number && missing_mines < component.variables_number; i++)
+            missing_mines += frontier->equations[component.first_equation + i].bias;
+        max_frontier_mines += missing_mines < component.variables_number ? missing_mines : component.variables_number;
+    }
+    return mines_left <= max_frontier_mines;
+}
+
+/**
+ * @brief Deduce cells under the global mine count, once the frontier equations alone deduce nothing.
+ * Mine probabilities are computed over the laid out frontier, together with the isolated unknown cells. When they are
+ * exact, a cell with probability 0 or 1 is clear or a mine in every configuration that meets the remaining mines
+ * (e.g. all remaining mines must lie on the frontier, so all isolated cells are clear).
+ * @param solver Solver context.
+ * @param moves Pointer to moves to append deterministic moves to.
+ * @return Error code.
+ */
+t_error_code deduce_global_cells(t_solver *solver, t_moves *moves) {
+    solver->probability_engine.deadline = solver->turn_deadline;
+    t_error_code error_code = compute_mine_probabilities(&solver->probability_engine, &solver->frontier,
+                                                         solver->number_of_mines, &solver->random_generator);
+    if (error_code || !solver->probability_engine.is_exact)
         return error_code;
-    t_matrix matrix = initialize_matrix(matrix_size, 0);
-    t_matrix variables_map = fill_matrix(board, matrix);
-    if (!matrix.data || !variables_map.data)
-        return ERROR_INITIALIZE_MATRIX_MEMORY_ALLOC;
-    log_variables_map(variables_map);
-    gauss_eliminate(matrix);
-    t_matrix deterministic_map = initialize_matrix(board_size, VARIABLES_MAP_NULL);
-    if (!deterministic_map.data)
-        return ERROR_INITIALIZE_MATRIX_MEMORY_ALLOC;
-    int deterministic_cells = mark_deterministic_cells(matrix, variables_map, deterministic_map);
-    if (deterministic_cells > 0)
-        extract_deterministic_moves(deterministic_map, deterministic_cells, moves);
-    else {
-        make_best_guess(board, moves, variables_map, matrix, total_number_of_mines);
+    if (append_probability_moves(solver, true, moves) > 0)
+        moves->stage = MOVE_STAGE_MINE_COUNT;
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Deduce cells of current frontier state, by local rules and otherwise by the whole frontier system.
+ * @param solver Solver context.
+ * @param moves Pointer to moves to append deterministic moves to.
+ * @return Error code.
+ */
+t_error_code deduce_cells(t_solver *solver, t_moves *moves) {
+    if (apply_local_rules(&solver->local_rules, &solver->frontier) == 0)
+        return deduce_frontier_cells(solver, moves);
+    extract_local_moves(&solver->local_rules, solver->board_size, moves);
+    moves->stage = MOVE_STAGE_LOCAL_RULES;
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Deduce all cells that follow from the board, without waiting for the board to be updated.
+ * Deduced cells are substituted into the kept equations (mines are flagged, and clear cells leave the equations
+ * around them), and the re-derived equations are solved again, until nothing new is deduced.
+ * The global mine count is applied last (only when it may bind, or before a guess), so when nothing is deduced,
+ * the mine probabilities are left ready for a guess. Once the turn deadline has passed, the moves so far are kept.
+ * @param solver Solver context.
+ * @param moves Pointer to (empty) moves to append deterministic moves to.
+ * @param is_probabilities_ready Pointer to boolean, set to true if probabilities are computed for the final state.
+ * @return Error code.
+ */
+t_error_code deduce_cells_to_fixpoint(t_solver *solver, t_moves *moves, bool *is_probabilities_ready) {
+    t_frontier *frontier = &solver->frontier;
+    *is_probabilities_ready = false;
+    while (true) {
+        size_t first_move = moves->number_of_moves;
+        t_error_code error_code = deduce_cells(solver, moves);
+        if (!error_code && moves->number_of_moves == first_move && !is_deadline_passed(solver->turn_deadline) &&
+            (first_move == 0 || is_mine_count_binding(&solver->frontier, solver->number_of_mines))) {
+            error_code = deduce_global_cells(solver, moves);
+            *is_probabilities_ready = !error_code;
+        }
+        if (error_code || moves->number_of_moves == first_move)
+            return error_code;
+        *is_probabilities_ready = false;
+        for (size_t i = first_move; i < moves->number_of_moves; i++)
+            decide_frontier_cell(frontier, moves->moves[i].cell, moves->moves[i].is_mine);
+        // Deductions are sound, so an illegal board is only reported by the next (real) update.
+        if (!propagate_frontier_decisions(frontier) || is_deadline_passed(solver->turn_deadline))
+            return RETURN_CODE_SUCCESS;
+    }
+}
+
+/**
+ * @brief Set the mine probability of every unknown cell of the turn board, from the state get_moves has left.
+ * Cells deduced by the turn are set to exactly 0 or 1, and the unknown cells they leave get the probabilities of the
+ * final frontier. Those are already computed if the turn guesses (or ends by the mine count); otherwise the turn ended
+ * by deductions, and the frontier they leave is laid out again and its probabilities are computed in full (estimated
+ * once the deadline has passed). The solver generator is not drawn from, so the next moves are the same as without
+ * the map.
+ * @param solver Solver context, after the moves of the turn are made.
+ * @param moves Moves of the turn.
+ * @param is_probabilities_ready True if probabilities are computed for the final state.
+ * @param probability_map Board-size matrix to set.
+ * @return Error code.
+ */
+t_error_code set_probability_map(t_solver *solver, t_moves moves, bool is_probabilities_ready,
+                                 t_matrix probability_map) {
+    t_frontier *frontier = &solver->frontier;
+    t_probability_engine *engine = &solver->probability_engine;
+    t_board known_board = frontier->known_board;
+    if (!is_probabilities_ready && !moves.is_guess) {
+        t_random_generator random_generator = solver->random_generator;
+        t_error_code error_code = RETURN_CODE_SUCCESS;
+        lay_out_frontier(frontier);
+        find_components(frontier);
+        engine->deadline = solver->turn_deadline;
+        if (is_deadline_passed(solver->turn_deadline))
+            estimate_mine_probabilities(engine, frontier, solver->number_of_mines);
+        else
+            error_code = compute_mine_probabilities(engine, frontier, solver->number_of_mines, &random_generator);
+        if (error_code)
+            return error_code;
+    }
+    reset_matrix(probability_map, PROBABILITY_MAP_NULL);
+    for (int variable = 0; variable < frontier->variables_number; variable++) {
+        t_board_cell cell = frontier->variables_cells[variable];
+        MATRIX_CELL(probability_map, cell.row, cell.col) = engine->variables_probabilities[variable];
+    }
+    if (frontier->unknown_cells > frontier->variables_number)
+        for (int row = 0; row < known_board.size.rows; row++)
+            for (int word = 0; word < known_board.words_per_row; word++)
+                for (uint64_t cells = get_isolated_cells(frontier, row, word); cells; cells &= cells - 1) {
+                    int col = word * BITBOARD_WORD_BITS + get_lowest_bit_index(cells);
+                    MATRIX_CELL(probability_map, row, col) = engine->isolated_probability;
+                }
+    for (size_t i = 0; !moves.is_guess && i < moves.number_of_moves; i++) {
+        t_board_cell cell = moves.moves[i].cell;
+        MATRIX_CELL(probability_map, cell.row, cell.col) = moves.moves[i].is_mine ? 1 : 0;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+t_error_code get_moves(t_solver *solver, t_board board, t_moves *moves) {
+    return get_moves_by_deadline(solver, board, NO_DEADLINE, moves);
+}
+
+t_error_code get_moves_within_budget(t_solver *solver, t_board board, uint64_t budget_microseconds, t_moves *moves) {
+    uint64_t deadline = NO_DEADLINE;
+    if (budget_microseconds < NO_DEADLINE / NANOSECONDS_IN_MICROSECOND)
+        deadline = get_deadline(budget_microseconds * NANOSECONDS_IN_MICROSECOND);
+    return get_moves_by_deadline(solver, board, deadline, moves);
+}
+
+t_error_code get_moves_by_deadline(t_solver *solver, t_board board, uint64_t deadline, t_moves *moves) {
+    t_matrix no_probability_map = {NULL, board.size};
+    return get_moves_with_probabilities(solver, board, deadline, moves, no_probability_map);
+}
+
+t_error_code get_moves_with_probabilities(t_solver *solver, t_board board, uint64_t deadline, t_moves *moves,
+                                          t_matrix probability_map) {
+    t_frontier *frontier = &solver->frontier;
+    int cells_number = board.size.rows * board.size.cols;
+    bool is_probabilities_ready = false;
+    t_error_code error_code;
+    if (probability_map.data &&
+        (probability_map.size.rows != board.size.rows || probability_map.size.cols != board.size.cols))
+        return ERROR_PROBABILITY_MAP_SIZE_MISMATCH;
+    solver->turn_deadline = deadline;
+    reset_arena(&solver->turn_arena);
+    if (!update_frontier(frontier, board)) {
+        log_illegal_cell(frontier->illegal_cell);
+        return ERROR_GET_MOVE_ILLEGAL_BOARD_DETECTED;
     }
-    free(variables_map.data);
-    free(deterministic_map.data);
-    free(matrix.data);
-    error_code = log_moves(*moves);
-    if (error_code)
+    moves->moves = (t_move *) allocate_from_arena(&solver->turn_arena, sizeof(t_move) * cells_number);
+    moves->number_of_moves = 0;
+    moves->is_guess = false;
+    moves->stage = MOVE_STAGE_NONE;
+    if (!moves->moves)
+        error_code = ERROR_ARENA_EXHAUSTED;
+    else
+        error_code = deduce_cells_to_fixpoint(solver, moves, &is_probabilities_ready);
+    if (!error_code && moves->number_of_moves == 0) {
+        if (is_probabilities_ready)
+            make_best_guess(solver, moves);
+        else
+            make_quick_guess(solver, moves);
+    }
+    if (!error_code && probability_map.data)
+        error_code = set_probability_map(solver, *moves, is_probabilities_ready, probability_map);
+    if (!error_code)
+        error_code = log_moves(*moves);
+    if (error_code) {
+        invalidate_frontier(frontier);
         return error_code;
+    }
     update_board_by_moves(board, *moves);
     return RETURN_CODE_SUCCESS;
 }
@@ -9,26 +9,87 @@
 #define MINESWEEPERSOLVER_BOARD_ANALYZER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "board.h"
+#include "matrix.h"
+#include "solver.h"
 
 struct move {
     t_board_cell cell;
     bool is_mine;
 };
 typedef struct move t_move;
+/**
+ * Deduction stages of get_moves, cheapest first.
+ */
+typedef enum {
+    MOVE_STAGE_NONE = 0,        // No deduction (first moves).
+    MOVE_STAGE_LOCAL_RULES,     // Single equation rules.
+    MOVE_STAGE_ELIMINATION,     // Reduction and Gaussian elimination of components.
+    MOVE_STAGE_MINE_COUNT,      // Exact probabilities under the global mine count.
+    MOVE_STAGE_PROBABILITY,     // Guess of the safest cell (exact or sampled probabilities).
+    MOVE_STAGE_ENDGAME,         // Guess of the highest win probability cell.
+    MOVE_STAGE_QUICK_GUESS      // Guess by linear time estimates, once deadline has passed.
+} t_move_stage;
+
 struct moves {
     t_move *moves;
     size_t number_of_moves;
+    bool is_guess; // True if moves are a guess, false if all moves are deterministic.
+    t_move_stage stage; // Last (most expensive) stage that produced moves.
 };
 typedef struct moves t_moves;
 
 /**
  * @brief Get moves for a given game state.
- * @param board Board pointer, containing board state.
+ * Moves memory is served by the solver turn arena, it is valid until the next turn and must not be freed.
+ * @param solver Solver context of the game.
+ * @param board The board, containing board state.
  * @param moves Pointer to moves.
- * @param total_number_of_mines Total number of mines in the level.
  * @return Error code.
  */
-t_error_code get_moves(t_board board, t_moves *moves, int total_number_of_mines);
+t_error_code get_moves(t_solver *solver, t_board board, t_moves *moves);
+
+/**
+ * @brief Get moves for a given game state, by a deadline.
+ * Deduction stages run cheapest first, and the deadline is checked between them (and between components, and within
+ * probabilities enumeration and sampling). Once it has passed, the deterministic moves found so far are returned,
+ * and if there are none, a guess by the best probabilities available (linear time estimates if there are none).
+ * The deadline may be missed by the duration of a single stage step (e.g. the elimination of a single component).
+ * @param solver Solver context of the game.
+ * @param board The board, containing board state.
+ * @param deadline Monotonic deadline in nanoseconds (see timer), or NO_DEADLINE.
+ * @param moves Pointer to moves, its stage is set to the stage that produced them.
+ * @return Error code.
+ */
+t_error_code get_moves_by_deadline(t_solver *solver, t_board board, uint64_t deadline, t_moves *moves);
+
+/**
+ * @brief Get moves for a given game state, within a time budget (see get_moves_by_deadline).
+ * @param solver Solver context of the game.
+ * @param board The board, containing board state.
+ * @param budget_microseconds Time budget in microseconds, starting now.
+ * @param moves Pointer to moves, its stage is set to the stage that produced them.
+ * @return Error code.
+ */
+t_error_code get_moves_within_budget(t_solver *solver, t_board board, uint64_t budget_microseconds, t_moves *moves);
+
+/**
+ * @brief Get moves for a given game state by a deadline (see get_moves_by_deadline), together with the mine
+ * probability of every unknown cell, from the same pass.
+ * Cells deduced by the turn are set to exactly 0 (clear) or 1 (mine), and other unknown cells to the probabilities
+ * that guesses are made by (exact, sampled, or estimated once the deadline has passed). When the turn ends by
+ * deductions, the frontier they leave is laid out again and its probabilities are computed in full, on top of the
+ * deductions. Moves of this turn and of later turns are the same as get_moves_by_deadline gives.
+ * @param solver Solver context of the game.
+ * @param board The board, containing board state.
+ * @param deadline Monotonic deadline in nanoseconds (see timer), or NO_DEADLINE.
+ * @param moves Pointer to moves, its stage is set to the stage that produced them.
+ * @param probability_map Board-size matrix (see initialize_matrix), set to the mine probability of the board unknown
+ * cells (before moves are applied), and to PROBABILITY_MAP_NULL for other cells. NULL data to skip it.
+ * @return Error code, ERROR_PROBABILITY_MAP_SIZE_MISMATCH if the map size differs from the board size.
+ */
+t_error_code get_moves_with_probabilities(t_solver *solver, t_board board, uint64_t deadline, t_moves *moves,
+                                          t_matrix probability_map);
 
 #endif //MINESWEEPERSOLVER_BOARD_ANALYZER_H
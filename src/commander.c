@@ -155,7 +155,6 @@ t_error_code execute_moves(t_moves moves) {
             goto lblCleanup;
     }
     lblCleanup:
-    free(moves.moves);
     return error_code;
 }
 
@@ -180,7 +179,7 @@ t_error_code set_minesweeper_level(t_level level) {
 }
 
 t_error_code restart_game(t_level level) {
-    POINT restart_game_point = level.point_game_restart;
+    POINT restart_game_point = {level.point_game_restart.x, level.point_game_restart.y};
     Sleep(SLEEP_RESTART_GAME_MILISECONDS);
     t_error_code error_code = translate_minesweeper_point_to_screen(&restart_game_point);
     if (error_code)
@@ -6,14 +6,18 @@
  * @brief Header commander module.
  * Exports functions that are required to play Minesweeper.
  * ALl functions require Windows OS (and uses windows.h and gdi32.dll).
+ * In HEADLESS builds the same functions are implemented by headless_commander over the simulator,
+ * and the screenshot API is not available.
  **************************************************************************************************/
 #ifndef MINESWEEPERSOLVER_COMMANDER_H
 #define MINESWEEPERSOLVER_COMMANDER_H
 
-#include "windows.h"
 #include "board_analyzer.h"
 #include "minesweeper_solver_utils.h"
 
+#ifndef HEADLESS
+#include "windows.h"
+
 /**
  * Struct for containing data of screenshot (size and pointer to image data).
  */
@@ -24,6 +28,8 @@ struct screenshot_data {
 };
 typedef struct screenshot_data t_screenshot_data;
 
+#endif
+
 /**
  * @brief Raise Minesweeper game.
  * @return Error code.
@@ -51,11 +57,13 @@ t_error_code set_minesweeper_level(t_level level);
  */
 t_error_code restart_game(t_level level);
 
+#ifndef HEADLESS
 /**
  * @brief Get screenshot of Minesweeper window (in Windows OS).
  * @param screenshot_data_ptr Pointer to screenshot data.
  * @return Error code.
  */
 t_error_code get_minesweeper_screenshot(t_screenshot_data *screenshot_data_ptr);
+#endif
 
 #endif //MINESWEEPERSOLVER_COMMANDER_H
\ No newline at end of file
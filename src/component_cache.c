@@ -0,0 +1,264 @@
+/**************************************************************************************************
+ * @file component_cache.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief component cache module, keeps the solutions of frontier components between turns and games.
+ * Most components are unchanged between turns, and small components recur in every game, so their deductions
+ * and configurations counts are looked up by the component key instead of being solved again.
+ * Cached solutions are kept in canonical variables order, and are solved over canonical equations, so a lookup
+ * gives exactly what solving the component would.
+**************************************************************************************************/
+#include <stdlib.h>
+#include "component_cache.h"
+
+#define COMPONENT_CACHE_VARIABLE_KIND 0
+#define COMPONENT_CACHE_ZOBRIST_SEED 0x2545f4914f6cdd1dULL
+
+/**
+ * @brief Get the Zobrist key of a table slot (splitmix64 of the slot).
+ * @param slot Slot index.
+ * @return Pseudo random key.
+ */
+uint64_t get_zobrist_key(uint64_t slot) {
+    uint64_t key = COMPONENT_CACHE_ZOBRIST_SEED + (slot + 1) * 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+t_error_code initialize_component_cache(t_component_cache *cache) {
+    int keys_number = COMPONENT_CACHE_MAX_SPAN * COMPONENT_CACHE_MAX_SPAN * COMPONENT_CACHE_KINDS;
+    cache->zobrist_keys = (uint64_t *) malloc(sizeof(uint64_t) * keys_number);
+    cache->entries = (t_component_entry *) calloc(COMPONENT_CACHE_BUCKETS * COMPONENT_CACHE_WAYS,
+                                                  sizeof(t_component_entry));
+    cache->clock_hands = (int *) calloc(COMPONENT_CACHE_BUCKETS, sizeof(int));
+    cache->is_mutex_initialized = !pthread_mutex_init(&cache->mutex, NULL);
+    cache->lookups = 0;
+    cache->hits = 0;
+    if (!cache->zobrist_keys || !cache->entries || !cache->clock_hands || !cache->is_mutex_initialized) {
+        free_component_cache(cache);
+        return ERROR_COMPONENT_CACHE_MEMORY_ALLOC;
+    }
+    for (int slot = 0; slot < keys_number; slot++)
+        cache->zobrist_keys[slot] = get_zobrist_key(slot);
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_component_cache(t_component_cache *cache) {
+    free(cache->zobrist_keys);
+    free(cache->entries);
+    free(cache->clock_hands);
+    if (cache->is_mutex_initialized)
+        pthread_mutex_destroy(&cache->mutex);
+    cache->is_mutex_initialized = false;
+    cache->zobrist_keys = NULL;
+    cache->entries = NULL;
+    cache->clock_hands = NULL;
+}
+
+/**
+ * @brief Map a board cell by a symmetry of the square (transpose, then mirror rows and columns).
+ * @param cell Board cell.
+ * @param transform Symmetry index, bit 2 transposes, bit 0 mirrors rows and bit 1 mirrors columns.
+ * @param row Pointer to mapped row.
+ * @param col Pointer to mapped column.
+ * @return Void.
+ */
+void transform_component_cell(t_board_cell cell, int transform, int *row, int *col) {
+    *row = (transform & 4) ? cell.col : cell.row;
+    *col = (transform & 4) ? cell.row : cell.col;
+    if (transform & 1)
+        *row = -*row;
+    if (transform & 2)
+        *col = -*col;
+}
+
+/**
+ * @brief Get the cell of component element, a variable or an equation.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @param element Element index, component variables first and then component equations.
+ * @param kind Pointer to element kind to set (variable, or equation bias + 1).
+ * @return Board cell of element.
+ */
+t_board_cell get_component_element(t_frontier *frontier, t_component component, int element, int *kind) {
+    if (element < component.variables_number) {
+        *kind = COMPONENT_CACHE_VARIABLE_KIND;
+        return frontier->variables_cells[component.first_variable + element];
+    }
+    t_equation *equation = &frontier->equations[component.first_equation + element - component.variables_number];
+    *kind = equation->bias + 1;
+    return equation->cell;
+}
+
+/**
+ * @brief Get the position of every component element relative to its bounding box, under a symmetry.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @param transform Symmetry index.
+ * @param positions Array to set, position (row * COMPONENT_CACHE_MAX_SPAN + col) of every element.
+ * @return Boolean, true if bounding box fits COMPONENT_CACHE_MAX_SPAN, false otherwise.
+ */
+bool get_component_positions(t_frontier *frontier, t_component component, int transform, int *positions) {
+    int elements_number = component.variables_number + component.equations_number;
+    int min_row = 0, min_col = 0, max_row = 0, max_col = 0, kind;
+    for (int element = 0; element < elements_number; element++) {
+        int row, col;
+        transform_component_cell(get_component_element(frontier, component, element, &kind), transform, &row, &col);
+        if (element == 0 || row < min_row)
+            min_row = row;
+        if (element == 0 || col < min_col)
+            min_col = col;
+        if (element == 0 || row > max_row)
+            max_row = row;
+        if (element == 0 || col > max_col)
+            max_col = col;
+        positions[element] = row * COMPONENT_CACHE_MAX_SPAN + col;
+    }
+    if (max_row - min_row >= COMPONENT_CACHE_MAX_SPAN || max_col - min_col >= COMPONENT_CACHE_MAX_SPAN)
+        return false;
+    for (int element = 0; element < elements_number; element++)
+        positions[element] -= min_row * COMPONENT_CACHE_MAX_SPAN + min_col;
+    return true;
+}
+
+/**
+ * @brief Sort indexes by their positions (insertion sort, positions are distinct).
+ * @param indexes Indexes to sort.
+ * @param positions Position of every index.
+ * @param indexes_number Number of indexes.
+ * @return Void.
+ */
+void sort_by_positions(int *indexes, const int *positions, int indexes_number) {
+    for (int i = 1; i < indexes_number; i++) {
+        int index = indexes[i], j = i - 1;
+        for (; j >= 0 && positions[indexes[j]] > positions[index]; j--)
+            indexes[j + 1] = indexes[j];
+        indexes[j + 1] = index;
+    }
+}
+
+/**
+ * @brief Set the canonical equations of a keyed component, over canonical variables.
+ * @param key Pointer to component key, with canonical variables set.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @param positions Canonical position of every component element.
+ * @return Void.
+ */
+void set_canonical_equations(t_component_key *key, t_frontier *frontier, t_component component,
+                             const int *positions) {
+    int canonical_indexes[COMPONENT_CACHE_MAX_VARIABLES];
+    int equations_order[COMPONENT_CACHE_MAX_EQUATIONS];
+    for (int i = 0; i < component.variables_number; i++)
+        canonical_indexes[key->canonical_variables[i]] = i;
+    for (int i = 0; i < component.equations_number; i++)
+        equations_order[i] = i;
+    sort_by_positions(equations_order, positions + component.variables_number, component.equations_number);
+    for (int i = 0; i < component.equations_number; i++) {
+        t_equation *equation = &key->equations[i];
+        *equation = frontier->equations[component.first_equation + equations_order[i]];
+        for (int k = 0; k < equation->variables_number; k++) {
+            int variable = component.first_variable +
+                           canonical_indexes[equation->variables[k] - component.first_variable], j = k - 1;
+            for (; j >= 0 && equation->variables[j] > variable; j--)
+                equation->variables[j + 1] = equation->variables[j];
+            equation->variables[j + 1] = variable;
+        }
+    }
+}
+
+bool key_component(const t_component_cache *cache, t_component_key *key, t_frontier *frontier,
+                   t_component component) {
+    int positions[COMPONENT_CACHE_MAX_VARIABLES + COMPONENT_CACHE_MAX_EQUATIONS];
+    int elements_number = component.variables_number + component.equations_number;
+    int best_transform = 0, kind;
+    uint64_t best_key = 0;
+    if (component.variables_number > COMPONENT_CACHE_MAX_VARIABLES ||
+        component.equations_number > COMPONENT_CACHE_MAX_EQUATIONS)
+        return false;
+    for (int transform = 0; transform < COMPONENT_CACHE_TRANSFORMS; transform++) {
+        uint64_t transform_key = 0;
+        if (!get_component_positions(frontier, component, transform, positions))
+            return false;
+        for (int element = 0; element < elements_number; element++) {
+            get_component_element(frontier, component, element, &kind);
+            transform_key ^= cache->zobrist_keys[positions[element] * COMPONENT_CACHE_KINDS + kind];
+        }
+        if (transform == 0 || transform_key < best_key) {
+            best_key = transform_key;
+            best_transform = transform;
+        }
+    }
+    get_component_positions(frontier, component, best_transform, positions);
+    key->key = best_key;
+    key->variables_number = component.variables_number;
+    key->equations_number = component.equations_number;
+    for (int i = 0; i < component.variables_number; i++)
+        key->canonical_variables[i] = i;
+    sort_by_positions(key->canonical_variables, positions, component.variables_number);
+    for (int i = 0; i < component.variables_number; i++)
+        key->variables_cells[i] = frontier->variables_cells[component.first_variable + key->canonical_variables[i]];
+    set_canonical_equations(key, frontier, component, positions);
+    return true;
+}
+
+void lock_component_cache(t_component_cache *cache) {
+    pthread_mutex_lock(&cache->mutex);
+}
+
+void unlock_component_cache(t_component_cache *cache) {
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+/**
+ * @brief Get the cached entry of a keyed component, without counting the lookup.
+ * @param cache Pointer to cache.
+ * @param key Pointer to component key.
+ * @return Pointer to entry, NULL if component is not cached.
+ */
+t_component_entry *get_bucket_entry(t_component_cache *cache, const t_component_key *key) {
+    t_component_entry *bucket = cache->entries + (key->key & (COMPONENT_CACHE_BUCKETS - 1)) * COMPONENT_CACHE_WAYS;
+    for (int way = 0; way < COMPONENT_CACHE_WAYS; way++) {
+        t_component_entry *entry = &bucket[way];
+        if (entry->is_used && entry->key == key->key && entry->variables_number == key->variables_number &&
+            entry->equations_number == key->equations_number) {
+            entry->is_referenced = true;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+t_component_entry *find_component_entry(t_component_cache *cache, const t_component_key *key) {
+    t_component_entry *entry = get_bucket_entry(cache, key);
+    cache->lookups++;
+    if (entry)
+        cache->hits++;
+    return entry;
+}
+
+t_component_entry *store_component_entry(t_component_cache *cache, const t_component_key *key) {
+    t_component_entry *entry = get_bucket_entry(cache, key);
+    if (entry)
+        return entry;
+    int bucket_index = (int) (key->key & (COMPONENT_CACHE_BUCKETS - 1));
+    t_component_entry *bucket = cache->entries + bucket_index * COMPONENT_CACHE_WAYS;
+    int *clock_hand = &cache->clock_hands[bucket_index];
+    while (true) {
+        entry = &bucket[*clock_hand];
+        *clock_hand = (*clock_hand + 1) % COMPONENT_CACHE_WAYS;
+        if (!entry->is_used || !entry->is_referenced)
+            break;
+        entry->is_referenced = false;
+    }
+    entry->key = key->key;
+    entry->variables_number = key->variables_number;
+    entry->equations_number = key->equations_number;
+    entry->is_used = true;
+    entry->is_referenced = true;
+    entry->is_deduced = false;
+    entry->is_distributed = false;
+    return entry;
+}
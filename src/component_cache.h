@@ -0,0 +1,134 @@
+/**************************************************************************************************
+ * @file component_cache.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for component cache module, exports the transposition table of frontier components solutions.
+ * A component is keyed by the Zobrist hash of its cells (variables, and equations by bias) relative to its bounding
+ * box, taken under the symmetry of the square (rotations and mirrors) that gives the lowest hash, so translated,
+ * rotated and mirrored copies of a component share an entry.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_COMPONENT_CACHE_H
+#define MINESWEEPERSOLVER_COMPONENT_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "error_codes.h"
+#include "frontier.h"
+
+#define COMPONENT_CACHE_MAX_VARIABLES 16        // Larger components are not cached (and never exceed search budget).
+#define COMPONENT_CACHE_MAX_EQUATIONS (COMPONENT_CACHE_MAX_VARIABLES * NEIGHBORS_NUMBER)
+#define COMPONENT_CACHE_MAX_SPAN 32             // Components with a wider bounding box are not cached.
+#define COMPONENT_CACHE_KINDS (NEIGHBORS_NUMBER + 2) // A variable cell, or an equation cell by its bias (0 to 8).
+#define COMPONENT_CACHE_BUCKETS 512             // Buckets of table (power of two).
+#define COMPONENT_CACHE_WAYS 4                  // Entries of every bucket, replaced by CLOCK.
+#define COMPONENT_CACHE_TRANSFORMS 8            // Symmetries of the square.
+#define COMPONENT_CACHE_UNDECIDED -1
+
+/**
+ * Struct for cached solution of a component, in canonical variables order.
+ */
+struct component_entry {
+    uint64_t key;
+    int variables_number;
+    int equations_number;
+    bool is_used;
+    bool is_referenced;                                         // CLOCK reference bit.
+    bool is_deduced;                                            // True if deductions are set.
+    bool is_distributed;                                        // True if configurations counts are set.
+    signed char deductions[COMPONENT_CACHE_MAX_VARIABLES];      // Value of deduced variables, or UNDECIDED.
+    uint32_t configurations[COMPONENT_CACHE_MAX_VARIABLES + 1]; // Number of configurations, by number of mines.
+    uint32_t variables_mines[COMPONENT_CACHE_MAX_VARIABLES * (COMPONENT_CACHE_MAX_VARIABLES + 1)];
+};
+typedef struct component_entry t_component_entry;
+
+/**
+ * Struct for the key and canonical form of a component, one for every thread that looks components up.
+ */
+struct component_key {
+    uint64_t key;
+    int variables_number;
+    int equations_number;
+    int canonical_variables[COMPONENT_CACHE_MAX_VARIABLES];     // Component variable of every canonical variable.
+    t_board_cell variables_cells[COMPONENT_CACHE_MAX_VARIABLES]; // Board cell of every canonical variable.
+    t_equation equations[COMPONENT_CACHE_MAX_EQUATIONS];        // Canonical equations, over canonical variables.
+};
+typedef struct component_key t_component_key;
+
+/**
+ * Struct for component cache.
+ * Entries depend on the component alone (not on the board or the game), so they are kept between games.
+ * The table is shared by the solver threads, entries are looked up and stored while the cache is locked.
+ */
+struct component_cache {
+    uint64_t *zobrist_keys;                                     // Key of every relative position and cell kind.
+    t_component_entry *entries;
+    int *clock_hands;                                           // Next entry to replace, of every bucket.
+    pthread_mutex_t mutex;
+    bool is_mutex_initialized;
+    long lookups;
+    long hits;
+};
+typedef struct component_cache t_component_cache;
+
+/**
+ * @brief Initialize component cache, with an empty table.
+ * @param cache Pointer to cache.
+ * @return Error code.
+ */
+t_error_code initialize_component_cache(t_component_cache *cache);
+
+/**
+ * @brief Free component cache.
+ * @param cache Pointer to cache.
+ * @return Void.
+ */
+void free_component_cache(t_component_cache *cache);
+
+/**
+ * @brief Compute the canonical form of a component.
+ * All 8 symmetries of the component cells are hashed (relative to their bounding box), and the lowest hash is the
+ * component key. Variables and equations are then ordered by their canonical position, and the canonical equations
+ * are set over variables first_variable + canonical index, so any copy of the component has equal canonical equations.
+ * @param cache Pointer to cache (read only, may be called without the lock).
+ * @param key Pointer to component key to set.
+ * @param frontier Pointer to frontier, after components split.
+ * @param component The component.
+ * @return Boolean, true if component is cacheable (small enough), false otherwise (canonical form is not set).
+ */
+bool key_component(const t_component_cache *cache, t_component_key *key, t_frontier *frontier,
+                   t_component component);
+
+/**
+ * @brief Lock the cache, before its entries are looked up, stored or read.
+ * @param cache Pointer to cache.
+ * @return Void.
+ */
+void lock_component_cache(t_component_cache *cache);
+
+/**
+ * @brief Unlock the cache, entries found or stored while locked must not be used after.
+ * @param cache Pointer to cache.
+ * @return Void.
+ */
+void unlock_component_cache(t_component_cache *cache);
+
+/**
+ * @brief Find the entry of a keyed component (cache must be locked).
+ * @param cache Pointer to cache.
+ * @param key Pointer to component key.
+ * @return Pointer to entry, NULL if component is not cached.
+ */
+t_component_entry *find_component_entry(t_component_cache *cache, const t_component_key *key);
+
+/**
+ * @brief Get the entry of a keyed component, and add it (empty) if it is not cached (cache must be locked).
+ * The entry replaced is the first one of the bucket that was not referenced since the clock hand last passed it.
+ * @param cache Pointer to cache.
+ * @param key Pointer to component key.
+ * @return Pointer to entry.
+ */
+t_component_entry *store_component_entry(t_component_cache *cache, const t_component_key *key);
+
+#endif //MINESWEEPERSOLVER_COMPONENT_CACHE_H
@@ -0,0 +1,341 @@
+/**************************************************************************************************
+ * @file endgame.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief endgame module, searches the guess that maximizes the probability of winning the game.
+ * Once few unknown cells are left, the safest cell is not necessarily the best guess, since a guess that reveals
+ * more about the other cells may avoid later guesses. The search plays out all remaining guesses over the set of
+ * consistent mines layouts.
+**************************************************************************************************/
+#include <stdlib.h>
+#include "common.h"
+#include "bitboard.h"
+#include "timer.h"
+#include "endgame.h"
+
+#define ENDGAME_TIMED_OUT -1.0
+#define ENDGAME_TIME_CHECK_NODES 256        // Search nodes between two clock readings.
+#define ENDGAME_OUTCOMES_NUMBER (NEIGHBORS_NUMBER + 2)  // Revealed numbers, and a last bucket for mines.
+#define ENDGAME_MINE_OUTCOME (NEIGHBORS_NUMBER + 1)
+#define ENDGAME_PROBABILITY_EPSILON 1e-9
+
+t_error_code initialize_endgame(t_endgame *endgame) {
+    endgame->layouts = (uint64_t *) malloc(sizeof(uint64_t) * ENDGAME_MAX_LAYOUTS);
+    endgame->layouts_scratch = (uint64_t *) malloc(sizeof(uint64_t) * ENDGAME_MAX_LAYOUTS);
+    endgame->memo = (t_endgame_entry *) calloc(ENDGAME_MEMO_CAPACITY, sizeof(t_endgame_entry));
+    endgame->cells_number = 0;
+    endgame->layouts_number = 0;
+    endgame->memo_size = 0;
+    endgame->stamp = 0;
+    if (!endgame->layouts || !endgame->layouts_scratch || !endgame->memo) {
+        free_endgame(endgame);
+        return ERROR_ENDGAME_MEMORY_ALLOC;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_endgame(t_endgame *endgame) {
+    free(endgame->layouts);
+    free(endgame->layouts_scratch);
+    free(endgame->memo);
+    endgame->layouts = NULL;
+    endgame->layouts_scratch = NULL;
+    endgame->memo = NULL;
+}
+
+/**
+ * @brief Check whether a board cell is one of the first endgame cells.
+ * @param endgame Pointer to endgame.
+ * @param cells_number Number of endgame cells to check.
+ * @param cell_index Board cell index.
+ * @return Boolean, true if cell is an endgame cell.
+ */
+bool is_endgame_cell(t_endgame *endgame, int cells_number, int cell_index) {
+    for (int i = 0; i < cells_number; i++)
+        if (endgame->cells[i] == cell_index)
+            return true;
+    return false;
+}
+
+/**
+ * @brief Map the unknown cells of frontier to endgame cells, and set their neighbors and equations.
+ * Frontier variables keep their indexes, and isolated cells follow in board order. Neighbors are found by cell
+ * coordinates (there are at most ENDGAME_MAX_CELLS cells).
+ * @param endgame Pointer to endgame.
+ * @param frontier Pointer to laid out frontier.
+ * @return Void.
+ */
+void prepare_endgame_cells(t_endgame *endgame, t_frontier *frontier) {
+    t_board known_board = frontier->known_board;
+    int cols = known_board.size.cols;
+    endgame->cells_number = 0;
+    for (int variable = 0; variable < frontier->variables_number; variable++) {
+        t_board_cell cell = frontier->variables_cells[variable];
+        endgame->cells[endgame->cells_number++] = cell.row * cols + cell.col;
+    }
+    for (int row = 0; row < known_board.size.rows; row++)
+        for (int word = 0; word < known_board.words_per_row; word++)
+            for (uint64_t cells = BOARD_PLANE_ROW(known_board, UNKNOWN_PLANE, row)[word]; cells; cells &= cells - 1) {
+                int cell_index = row * cols + word * BITBOARD_WORD_BITS + get_lowest_bit_index(cells);
+                if (!is_endgame_cell(endgame, frontier->variables_number, cell_index))
+                    endgame->cells[endgame->cells_number++] = cell_index;
+            }
+    for (int i = 0; i < endgame->cells_number; i++) {
+        int row = endgame->cells[i] / cols, col = endgame->cells[i] % cols;
+        endgame->neighbors[i] = 0;
+        endgame->cells_equations_number[i] = 0;
+        for (int j = 0; j < endgame->cells_number; j++) {
+            int row_distance = abs(endgame->cells[j] / cols - row), col_distance = abs(endgame->cells[j] % cols - col);
+            if (j != i && row_distance <= 1 && col_distance <= 1)
+                endgame->neighbors[i] |= (uint64_t) 1 << j;
+        }
+    }
+    for (int i = 0; i < frontier->equations_number; i++) {
+        t_equation *equation = &frontier->equations[i];
+        endgame->equations_bias[i] = equation->bias;
+        endgame->equations_unassigned[i] = equation->variables_number;
+        for (int k = 0; k < equation->variables_number; k++) {
+            int cell = equation->variables[k];
+            endgame->cells_equations[cell * NEIGHBORS_NUMBER + endgame->cells_equations_number[cell]++] = i;
+        }
+    }
+}
+
+/**
+ * @brief Assign (or unassign) a value of an endgame cell, and update the state of its equations.
+ * @param endgame Pointer to endgame.
+ * @param cell Endgame cell.
+ * @param value Cell value (1 for a mine).
+ * @param direction 1 to assign, -1 to unassign.
+ * @return Boolean, true if all equations of cell can still be satisfied, false otherwise.
+ */
+bool apply_endgame_value(t_endgame *endgame, int cell, int value, int direction) {
+    bool is_consistent = true;
+    for (int k = 0; k < endgame->cells_equations_number[cell]; k++) {
+        int equation = endgame->cells_equations[cell * NEIGHBORS_NUMBER + k];
+        endgame->equations_unassigned[equation] -= direction;
+        endgame->equations_bias[equation] -= direction * value;
+        if (endgame->equations_bias[equation] < 0 ||
+            endgame->equations_bias[equation] > endgame->equations_unassigned[equation])
+            is_consistent = false;
+    }
+    return is_consistent;
+}
+
+/**
+ * @brief Enumerate all consistent mines layouts of the endgame cells from a cell on, using backtracking.
+ * @param endgame Pointer to endgame.
+ * @param cell First unassigned endgame cell.
+ * @param mines Number of mines assigned so far.
+ * @param layout Layout assigned so far.
+ * @return Boolean, true if enumeration is done, false if there are more than ENDGAME_MAX_LAYOUTS layouts.
+ */
+bool enumerate_endgame_layouts(t_endgame *endgame, int cell, int mines, uint64_t layout) {
+    if (mines > endgame->mines_left || mines + endgame->cells_number - cell < endgame->mines_left)
+        return true;
+    if (cell == endgame->cells_number) {
+        if (endgame->layouts_number == ENDGAME_MAX_LAYOUTS)
+            return false;
+        endgame->layouts[endgame->layouts_number++] = layout;
+        return true;
+    }
+    for (int value = 0; value <= 1; value++) {
+        bool is_done = true;
+        if (apply_endgame_value(endgame, cell, value, 1))
+            is_done = enumerate_endgame_layouts(endgame, cell + 1, mines + value,
+                                                layout | ((uint64_t) value << cell));
+        apply_endgame_value(endgame, cell, value, -1);
+        if (!is_done)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Get the memo key of a single layout (a mix of its bits).
+ * @param layout The layout.
+ * @return Layout key.
+ */
+uint64_t get_layout_key(uint64_t layout) {
+    layout = (layout ^ (layout >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    layout = (layout ^ (layout >> 27)) * 0x94d049bb133111ebULL;
+    return layout ^ (layout >> 31);
+}
+
+/**
+ * @brief Find the memo slot of a set of layouts, either its entry or the empty slot it belongs to.
+ * @param endgame Pointer to endgame.
+ * @param fingerprint Sum of layouts keys.
+ * @param layouts_number Number of layouts.
+ * @return Pointer to memo entry.
+ */
+t_endgame_entry *find_endgame_entry(t_endgame *endgame, uint64_t fingerprint, int layouts_number) {
+    int slot = (int) (fingerprint & (ENDGAME_MEMO_CAPACITY - 1));
+    while (endgame->memo[slot].stamp == endgame->stamp &&
+           (endgame->memo[slot].fingerprint != fingerprint || endgame->memo[slot].layouts_number != layouts_number))
+        slot = (slot + 1) & (ENDGAME_MEMO_CAPACITY - 1);
+    return &endgame->memo[slot];
+}
+
+/**
+ * @brief Get the number revealed by a clear cell in a layout (counting the unknown neighbors only).
+ * @param endgame Pointer to endgame.
+ * @param layout The layout.
+ * @param cell Endgame cell, clear in layout.
+ * @return Revealed number, or ENDGAME_MINE_OUTCOME if cell is a mine in layout.
+ */
+int get_endgame_outcome(t_endgame *endgame, uint64_t layout, int cell) {
+    if ((layout >> cell) & 1)
+        return ENDGAME_MINE_OUTCOME;
+    return POPCOUNT64(layout & endgame->neighbors[cell]);
+}
+
+double search_endgame(t_endgame *endgame, int first_layout, int layouts_number, int *best_cell);
+
+/**
+ * @brief Get the win probability of revealing a cell, over a set of layouts.
+ * Layouts are grouped (in place) by the outcome of cell, and every group of a clear outcome is searched.
+ * @param endgame Pointer to endgame.
+ * @param first_layout Index of first layout.
+ * @param layouts_number Number of layouts.
+ * @param cell Revealed endgame cell.
+ * @return Win probability, or ENDGAME_TIMED_OUT.
+ */
+double reveal_endgame_cell(t_endgame *endgame, int first_layout, int layouts_number, int cell) {
+    uint64_t *layouts = endgame->layouts + first_layout;
+    int outcomes_offsets[ENDGAME_OUTCOMES_NUMBER + 1] = {0};
+    for (int i = 0; i < layouts_number; i++)
+        outcomes_offsets[get_endgame_outcome(endgame, layouts[i], cell) + 1]++;
+    for (int outcome = 0; outcome < ENDGAME_OUTCOMES_NUMBER; outcome++)
+        outcomes_offsets[outcome + 1] += outcomes_offsets[outcome];
+    int outcomes_positions[ENDGAME_OUTCOMES_NUMBER];
+    for (int outcome = 0; outcome < ENDGAME_OUTCOMES_NUMBER; outcome++)
+        outcomes_positions[outcome] = outcomes_offsets[outcome];
+    for (int i = 0; i < layouts_number; i++)
+        endgame->layouts_scratch[outcomes_positions[get_endgame_outcome(endgame, layouts[i], cell)]++] = layouts[i];
+    for (int i = 0; i < layouts_number; i++)
+        layouts[i] = endgame->layouts_scratch[i];
+    double win_weight = 0;
+    for (int outcome = 0; outcome < ENDGAME_MINE_OUTCOME; outcome++) {
+        int outcome_layouts = outcomes_offsets[outcome + 1] - outcomes_offsets[outcome];
+        if (outcome_layouts == 0)
+            continue;
+        double win_probability = search_endgame(endgame, first_layout + outcomes_offsets[outcome], outcome_layouts,
+                                                NULL);
+        if (win_probability == ENDGAME_TIMED_OUT)
+            return ENDGAME_TIMED_OUT;
+        win_weight += outcome_layouts * win_probability;
+    }
+    return win_weight / layouts_number;
+}
+
+/**
+ * @brief Search the win probability of a state, the set of layouts consistent with all revealed cells.
+ * @param endgame Pointer to endgame.
+ * @param first_layout Index of first layout.
+ * @param layouts_number Number of layouts.
+ * @param best_cell Pointer to endgame cell to set to the best move, NULL to skip (and use memo).
+ * @return Win probability, or ENDGAME_TIMED_OUT.
+ */
+double search_endgame(t_endgame *endgame, int first_layout, int layouts_number, int *best_cell) {
+    uint64_t *layouts = endgame->layouts + first_layout;
+    if (layouts_number == 1 && !best_cell)
+        return 1;
+    if (endgame->is_timed_out || ++endgame->search_nodes > endgame->node_budget ||
+        (endgame->search_nodes % ENDGAME_TIME_CHECK_NODES == 0 && is_deadline_passed(endgame->deadline))) {
+        endgame->is_timed_out = true;
+        return ENDGAME_TIMED_OUT;
+    }
+    uint64_t fingerprint = 0, any_mine = 0, all_mines = ~(uint64_t) 0;
+    for (int i = 0; i < layouts_number; i++) {
+        fingerprint += get_layout_key(layouts[i]);
+        any_mine |= layouts[i];
+        all_mines &= layouts[i];
+    }
+    t_endgame_entry *entry = find_endgame_entry(endgame, fingerprint, layouts_number);
+    if (!best_cell && entry->stamp == endgame->stamp)
+        return entry->win_probability;
+    uint64_t cells_mask = endgame->cells_number == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << endgame->cells_number) - 1;
+    double win_probability = ENDGAME_TIMED_OUT;
+    // A clear cell that tells layouts apart is revealed for free (revealed cells never tell them apart).
+    bool is_revealed_free = false;
+    for (uint64_t cells = ~any_mine & cells_mask; cells && !is_revealed_free; cells &= cells - 1) {
+        int cell = get_lowest_bit_index(cells);
+        int outcome = get_endgame_outcome(endgame, layouts[0], cell);
+        for (int i = 1; i < layouts_number; i++)
+            if (get_endgame_outcome(endgame, layouts[i], cell) != outcome) {
+                is_revealed_free = true;
+                win_probability = reveal_endgame_cell(endgame, first_layout, layouts_number, cell);
+                if (best_cell)
+                    *best_cell = cell;
+                break;
+            }
+    }
+    if (!is_revealed_free) {
+        // Guesses are tried by descending clear probability, which bounds their win probability.
+        int candidates[ENDGAME_MAX_CELLS], clear_layouts[ENDGAME_MAX_CELLS], candidates_number = 0;
+        for (uint64_t cells = any_mine & ~all_mines; cells; cells &= cells - 1) {
+            int cell = get_lowest_bit_index(cells), cell_clear_layouts = 0;
+            for (int i = 0; i < layouts_number; i++)
+                cell_clear_layouts += !((layouts[i] >> cell) & 1);
+            int position = candidates_number++;
+            for (; position > 0 && clear_layouts[position - 1] < cell_clear_layouts; position--) {
+                candidates[position] = candidates[position - 1];
+                clear_layouts[position] = clear_layouts[position - 1];
+            }
+            candidates[position] = cell;
+            clear_layouts[position] = cell_clear_layouts;
+        }
+        win_probability = 0;
+        for (int i = 0; i < candidates_number; i++) {
+            if ((double) clear_layouts[i] / layouts_number <= win_probability + ENDGAME_PROBABILITY_EPSILON)
+                break;
+            double cell_win_probability = reveal_endgame_cell(endgame, first_layout, layouts_number, candidates[i]);
+            if (cell_win_probability == ENDGAME_TIMED_OUT)
+                return ENDGAME_TIMED_OUT;
+            if (cell_win_probability > win_probability + ENDGAME_PROBABILITY_EPSILON || i == 0) {
+                win_probability = cell_win_probability;
+                if (best_cell)
+                    *best_cell = candidates[i];
+            }
+        }
+    }
+    if (win_probability == ENDGAME_TIMED_OUT)
+        return ENDGAME_TIMED_OUT;
+    // Entry is re-found, since the slot may have been taken by the searches of sub-states.
+    entry = find_endgame_entry(endgame, fingerprint, layouts_number);
+    if (entry->stamp != endgame->stamp && endgame->memo_size < ENDGAME_MEMO_CAPACITY / 2) {
+        entry->fingerprint = fingerprint;
+        entry->layouts_number = layouts_number;
+        entry->stamp = endgame->stamp;
+        entry->win_probability = win_probability;
+        endgame->memo_size++;
+    }
+    return win_probability;
+}
+
+bool solve_endgame(t_endgame *endgame, t_frontier *frontier, int mines_left, long node_budget, uint64_t deadline,
+                   t_board_cell *best_cell) {
+    ASSERT(frontier->unknown_cells <= ENDGAME_MAX_CELLS);
+    int cols = frontier->known_board.size.cols, best_endgame_cell = ENDGAME_NO_CELL;
+    prepare_endgame_cells(endgame, frontier);
+    endgame->mines_left = mines_left;
+    endgame->layouts_number = 0;
+    bool is_solved = enumerate_endgame_layouts(endgame, 0, 0, 0) && endgame->layouts_number > 0;
+    if (is_solved) {
+        endgame->stamp++;
+        endgame->memo_size = 0;
+        endgame->search_nodes = 0;
+        endgame->is_timed_out = false;
+        endgame->node_budget = node_budget;
+        endgame->deadline = deadline;
+        is_solved = search_endgame(endgame, 0, endgame->layouts_number, &best_endgame_cell) != ENDGAME_TIMED_OUT &&
+                    best_endgame_cell != ENDGAME_NO_CELL;
+    }
+    if (is_solved) {
+        best_cell->row = endgame->cells[best_endgame_cell] / cols;
+        best_cell->col = endgame->cells[best_endgame_cell] % cols;
+    }
+    return is_solved;
+}
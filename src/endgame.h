@@ -0,0 +1,96 @@
+/**************************************************************************************************
+ * @file endgame.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for endgame module, exports the exhaustive endgame guess that maximizes win probability.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_ENDGAME_H
+#define MINESWEEPERSOLVER_ENDGAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "error_codes.h"
+#include "board.h"
+#include "frontier.h"
+
+#define ENDGAME_MAX_CELLS 28                    // Endgame is searched once unknown cells are at most this number.
+#define ENDGAME_MAX_LAYOUTS 4096                // Endgame is not searched if it has more consistent mines layouts.
+#define ENDGAME_MEMO_CAPACITY (1 << 14)         // Slots of search memo (power of two).
+#define ENDGAME_DEFAULT_NODE_BUDGET (1 << 16)   // Default search nodes budget of a single guess (about 20ms).
+#define ENDGAME_NO_CELL -1
+
+/**
+ * Struct for a memoized endgame state, identified by its set of consistent layouts.
+ */
+struct endgame_entry {
+    uint64_t fingerprint;   // Sum of layouts keys.
+    int layouts_number;
+    int stamp;              // Entry is empty unless stamp is the search stamp.
+    double win_probability;
+};
+typedef struct endgame_entry t_endgame_entry;
+
+/**
+ * Struct for endgame search state.
+ * Every unknown cell is an endgame cell (frontier variables first, in variables order, then isolated cells), and a
+ * mines layout has a bit for every endgame cell.
+ */
+struct endgame {
+    int cells[ENDGAME_MAX_CELLS];                               // Board cell index of every endgame cell.
+    int cells_number;
+    uint64_t neighbors[ENDGAME_MAX_CELLS];                      // Endgame neighbor cells of every endgame cell.
+    int cells_equations[ENDGAME_MAX_CELLS * NEIGHBORS_NUMBER];  // Frontier equations of every endgame cell.
+    int cells_equations_number[ENDGAME_MAX_CELLS];
+    int equations_bias[ENDGAME_MAX_CELLS * NEIGHBORS_NUMBER];   // Missing mines of every frontier equation.
+    int equations_unassigned[ENDGAME_MAX_CELLS * NEIGHBORS_NUMBER];
+    int mines_left;
+    uint64_t *layouts;                                          // Consistent mines layouts.
+    uint64_t *layouts_scratch;
+    int layouts_number;
+    t_endgame_entry *memo;
+    int memo_size;
+    int stamp;
+    uint64_t deadline;                                          // Monotonic time the search is aborted at.
+    long node_budget;                                           // Search nodes the search is aborted after.
+    long search_nodes;
+    bool is_timed_out;
+};
+typedef struct endgame t_endgame;
+
+/**
+ * @brief Initialize endgame buffers.
+ * @param endgame Pointer to endgame.
+ * @return Error code.
+ */
+t_error_code initialize_endgame(t_endgame *endgame);
+
+/**
+ * @brief Free endgame buffers.
+ * @param endgame Pointer to endgame.
+ * @return Void.
+ */
+void free_endgame(t_endgame *endgame);
+
+/**
+ * @brief Find the guess that maximizes the probability of winning the game.
+ * All mines layouts of the unknown cells that are consistent with the frontier equations and the remaining mines are
+ * enumerated (all of them are equally likely). The search then plays every cell that is not a mine in all layouts,
+ * splits the layouts where it is clear by the number revealed, and recurses, while a cell that is clear in all
+ * layouts and tells them apart is revealed for free. A state is won once a single layout is left. States are
+ * memoized by their set of layouts, and a cell is skipped once its clear probability can't beat the best cell.
+ * The search is bounded by a number of search nodes, so its result depends only on the game state. A deadline
+ * bounds it further by the clock (and then the result depends on timing).
+ * @param endgame Pointer to endgame.
+ * @param frontier Pointer to laid out frontier, with at most ENDGAME_MAX_CELLS unknown cells.
+ * @param mines_left Number of mines that are not flagged.
+ * @param node_budget Search nodes budget.
+ * @param deadline Monotonic deadline in nanoseconds (see timer), or NO_DEADLINE.
+ * @param best_cell Pointer to cell to set to the best guess.
+ * @return Boolean, true if search is done, false if layouts, nodes budget or deadline have exceeded (best_cell is
+ * not set).
+ */
+bool solve_endgame(t_endgame *endgame, t_frontier *frontier, int mines_left, long node_budget, uint64_t deadline,
+                   t_board_cell *best_cell);
+
+#endif //MINESWEEPERSOLVER_ENDGAME_H
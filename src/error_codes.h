@@ -40,7 +40,27 @@ typedef enum {
     ERROR_CREATING_LOGS_DIRECTORY,
     ERROR_WRITE_LOG_FFLUSH_FAILED,
     ERROR_WRITE_LOG_FPRINTF_FAILED,
-    ERROR_INITIALIZE_MATRIX_MEMORY_ALLOC
+    ERROR_INITIALIZE_MATRIX_MEMORY_ALLOC,
+    ERROR_INITIALIZE_GAME_MEMORY_ALLOC,
+    ERROR_SIMULATE_MOVE_OUT_OF_BOARD,
+    ERROR_BENCH_MEMORY_ALLOC,
+    ERROR_BENCH_GAME_STALLED,
+    ERROR_BATCH_MEMORY_ALLOC,
+    ERROR_BATCH_THREAD_CREATE,
+    ERROR_INITIALIZE_FRONTIER_MEMORY_ALLOC,
+    ERROR_PROBABILITY_MEMORY_ALLOC,
+    ERROR_ARENA_MEMORY_ALLOC,
+    ERROR_ARENA_EXHAUSTED,
+    ERROR_LOCAL_RULES_MEMORY_ALLOC,
+    ERROR_REDUCTION_MEMORY_ALLOC,
+    ERROR_ENDGAME_MEMORY_ALLOC,
+    ERROR_COMPONENT_CACHE_MEMORY_ALLOC,
+    ERROR_SPARSE_MATRIX_MEMORY_ALLOC,
+    ERROR_THREAD_POOL_MEMORY_ALLOC,
+    ERROR_THREAD_POOL_THREAD_CREATE,
+    ERROR_INCORRECT_USAGE_ILLEGAL_ARG,
+    ERROR_THREADS_CHECK_MOVES_MISMATCH,
+    ERROR_PROBABILITY_MAP_SIZE_MISMATCH
 } t_error_code;
 
 #endif //MINESWEEPERSOLVER_ERROR_CODES_H
@@ -0,0 +1,498 @@
+/**************************************************************************************************
+ * @file frontier.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief frontier module, builds the unknown cells equations system of a board.
+ * Every numeric cell with unknown neighbors is an equation over its unknown neighbors (variables).
+ * Equations are kept between turns by cell (as bitplanes of equation cells, derived from the known board when needed),
+ * and only the equations around changed cells are re-derived.
+ * Changed cells are found by comparing bitplanes, and the cells around them are verified and counted a row word
+ * (64 cells) at a time.
+ * Equations that share variables are connected, and the system is split into independent components
+ * (using union-find over variables), so every component can be solved as its own small system.
+**************************************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "common.h"
+#include "bitboard.h"
+#include "frontier.h"
+
+t_error_code initialize_frontier(t_frontier *frontier, t_board_size board_size) {
+    int cells_number = board_size.rows * board_size.cols;
+    int words_per_row = get_words_per_row(board_size.cols);
+    size_t plane_words = (size_t) board_size.rows * words_per_row;
+    t_board known_board = {NULL, board_size, words_per_row, NULL, NULL};
+    frontier->known_board = known_board;
+    frontier->is_synchronized = false;
+    frontier->derived_cells_number = 0;
+    frontier->equations_number = 0;
+    frontier->variables_number = 0;
+    frontier->components_number = 0;
+    frontier->unknown_cells = 0;
+    frontier->flagged_mines = 0;
+    frontier->layout_stamp = 0;
+    frontier->equations = (t_equation *) malloc(sizeof(t_equation) * cells_number);
+    frontier->equations_scratch = (t_equation *) malloc(sizeof(t_equation) * cells_number);
+    frontier->variables_cells = (t_board_cell *) malloc(sizeof(t_board_cell) * cells_number);
+    frontier->variables_cells_scratch = (t_board_cell *) malloc(sizeof(t_board_cell) * cells_number);
+    frontier->components = (t_component *) malloc(sizeof(t_component) * cells_number);
+    frontier->union_find_parents = (int *) malloc(sizeof(int) * cells_number);
+    frontier->variables_components = (int *) malloc(sizeof(int) * cells_number);
+    frontier->renumbered_variables = (int *) malloc(sizeof(int) * cells_number);
+    frontier->known_board.planes = (uint64_t *) malloc(sizeof(uint64_t) * plane_words * BOARD_PLANES_NUMBER);
+    frontier->equations_mask = (uint64_t *) malloc(sizeof(uint64_t) * plane_words);
+    frontier->pending_mask = (uint64_t *) malloc(sizeof(uint64_t) * plane_words);
+    frontier->changed_mask = (uint64_t *) calloc(plane_words, sizeof(uint64_t));
+    frontier->changed_words = (uint64_t *) calloc(get_changed_words_length(board_size), sizeof(uint64_t));
+    frontier->affected_words = (uint64_t *) calloc(get_changed_words_length(board_size), sizeof(uint64_t));
+    frontier->derived_cells = (int *) malloc(sizeof(int) * cells_number);
+    frontier->variables_slots = (t_variable_slot *) calloc((size_t) 3 * board_size.cols, sizeof(t_variable_slot));
+    if (!frontier->equations || !frontier->equations_scratch || !frontier->variables_cells ||
+        !frontier->variables_cells_scratch || !frontier->components || !frontier->union_find_parents ||
+        !frontier->variables_components || !frontier->renumbered_variables || !frontier->known_board.planes ||
+        !frontier->equations_mask || !frontier->pending_mask || !frontier->changed_mask || !frontier->changed_words ||
+        !frontier->affected_words || !frontier->derived_cells || !frontier->variables_slots) {
+        free_frontier(frontier);
+        return ERROR_INITIALIZE_FRONTIER_MEMORY_ALLOC;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_frontier(t_frontier *frontier) {
+    free(frontier->equations);
+    free(frontier->equations_scratch);
+    free(frontier->variables_cells);
+    free(frontier->variables_cells_scratch);
+    free(frontier->components);
+    free(frontier->union_find_parents);
+    free(frontier->variables_components);
+    free(frontier->renumbered_variables);
+    free(frontier->known_board.planes);
+    free(frontier->equations_mask);
+    free(frontier->pending_mask);
+    free(frontier->changed_mask);
+    free(frontier->changed_words);
+    free(frontier->affected_words);
+    free(frontier->derived_cells);
+    free(frontier->variables_slots);
+    frontier->equations = NULL;
+    frontier->equations_scratch = NULL;
+    frontier->variables_cells = NULL;
+    frontier->variables_cells_scratch = NULL;
+    frontier->components = NULL;
+    frontier->union_find_parents = NULL;
+    frontier->variables_components = NULL;
+    frontier->renumbered_variables = NULL;
+    frontier->known_board.planes = NULL;
+    frontier->equations_mask = NULL;
+    frontier->pending_mask = NULL;
+    frontier->changed_mask = NULL;
+    frontier->changed_words = NULL;
+    frontier->affected_words = NULL;
+    frontier->derived_cells = NULL;
+    frontier->variables_slots = NULL;
+}
+
+/**
+ * @brief Check whether a cell is set in a frontier bitplane (of known board size).
+ * @param frontier Pointer to frontier.
+ * @param mask The bitplane.
+ * @param cell_index Cell index.
+ * @return Boolean, true if cell bit is set.
+ */
+bool is_mask_cell_set(t_frontier *frontier, const uint64_t *mask, int cell_index) {
+    int cols = frontier->known_board.size.cols;
+    uint64_t word = mask[(size_t) (cell_index / cols) * frontier->known_board.words_per_row +
+                         (cell_index % cols) / BITBOARD_WORD_BITS];
+    return (word >> ((cell_index % cols) % BITBOARD_WORD_BITS)) & 1;
+}
+
+bool has_kept_equation(t_frontier *frontier, int cell_index) {
+    return is_mask_cell_set(frontier, frontier->equations_mask, cell_index);
+}
+
+void invalidate_frontier(t_frontier *frontier) {
+    frontier->is_synchronized = false;
+}
+
+/**
+ * @brief Compare a plane word of board against known board, and copy it (and mark its changed cells) if it differs.
+ * Counts of unknown cells and flagged mines are updated by the changed bits.
+ * @param frontier Pointer to frontier.
+ * @param board The board.
+ * @param word_index Word index in plane (row-major).
+ * @return Boolean, true if any cell of word has changed.
+ */
+bool compare_board_word(t_frontier *frontier, t_board board, size_t word_index) {
+    t_board known_board = frontier->known_board;
+    size_t plane_words = (size_t) board.size.rows * board.words_per_row;
+    uint64_t changed = 0;
+    for (int plane = 0; plane < BOARD_PLANES_NUMBER; plane++)
+        changed |= board.planes[plane * plane_words + word_index] ^
+                   known_board.planes[plane * plane_words + word_index];
+    if (!changed)
+        return false;
+    uint64_t *known_unknowns = known_board.planes + UNKNOWN_PLANE * plane_words + word_index;
+    uint64_t *known_mines = known_board.planes + MINE_PLANE * plane_words + word_index;
+    frontier->unknown_cells += POPCOUNT64(board.planes[UNKNOWN_PLANE * plane_words + word_index]) -
+                               POPCOUNT64(*known_unknowns);
+    frontier->flagged_mines += POPCOUNT64(board.planes[MINE_PLANE * plane_words + word_index]) -
+                               POPCOUNT64(*known_mines);
+    for (int plane = 0; plane < BOARD_PLANES_NUMBER; plane++)
+        known_board.planes[plane * plane_words + word_index] = board.planes[plane * plane_words + word_index];
+    frontier->changed_mask[word_index] |= changed;
+    frontier->changed_words[word_index / BITBOARD_WORD_BITS] |= (uint64_t) 1 << (word_index % BITBOARD_WORD_BITS);
+    return true;
+}
+
+/**
+ * @brief Find the changed cells of board (any bitplane differs from known board), and copy the changed plane words.
+ * Only the words marked in board changed words are compared (their marks are cleared), unless the frontier is not
+ * synchronized or the board has no changed words bitmap, and then all words are.
+ * @param frontier Pointer to frontier.
+ * @param board The board.
+ * @param is_whole_board Whether all plane words are compared.
+ * @return Boolean, true if any cell has changed.
+ */
+bool find_changed_cells(t_frontier *frontier, t_board board, bool is_whole_board) {
+    size_t plane_words = (size_t) board.size.rows * board.words_per_row;
+    size_t changed_words_length = get_changed_words_length(board.size);
+    bool is_changed = false;
+    if (is_whole_board || !board.changed_words) {
+        for (size_t i = 0; i < plane_words; i++)
+            is_changed |= compare_board_word(frontier, board, i);
+        if (board.changed_words)
+            memset(board.changed_words, 0, sizeof(uint64_t) * changed_words_length);
+        return is_changed;
+    }
+    for (size_t i = 0; i < changed_words_length; i++) {
+        for (uint64_t words = board.changed_words[i]; words; words &= words - 1)
+            is_changed |= compare_board_word(frontier, board, i * BITBOARD_WORD_BITS + get_lowest_bit_index(words));
+        board.changed_words[i] = 0;
+    }
+    return is_changed;
+}
+
+int get_cell_neighbors(t_board_size board_size, int cell_index, int neighbors[NEIGHBORS_NUMBER]) {
+    int row = cell_index / board_size.cols, col = cell_index % board_size.cols;
+    int neighbors_number = 0;
+    for (int row_offset = -1; row_offset <= 1; row_offset++)
+        for (int col_offset = -1; col_offset <= 1; col_offset++) {
+            int neighbor_row = row + row_offset, neighbor_col = col + col_offset;
+            if ((row_offset || col_offset) && neighbor_row >= 0 && neighbor_row < board_size.rows &&
+                neighbor_col >= 0 && neighbor_col < board_size.cols)
+                neighbors[neighbors_number++] = neighbor_row * board_size.cols + neighbor_col;
+        }
+    return neighbors_number;
+}
+
+void get_kept_equation(t_frontier *frontier, int cell_index, t_equation *equation) {
+    t_board known_board = frontier->known_board;
+    int cols = known_board.size.cols;
+    int neighbors[NEIGHBORS_NUMBER];
+    int neighbors_number = get_cell_neighbors(known_board.size, cell_index, neighbors);
+    t_board_cell cell = {cell_index / cols, cell_index % cols};
+    equation->cell = cell;
+    equation->bias = 0;
+    equation->variables_number = 0;
+    equation->is_pending = is_mask_cell_set(frontier, frontier->pending_mask, cell_index);
+    for (int i = 0; i < NUMBER_PLANES_NUMBER; i++)
+        equation->bias |= is_board_plane_set(known_board, NUMBER_PLANE + i, cell.row, cell.col) << i;
+    for (int k = 0; k < neighbors_number; k++) {
+        int neighbor_row = neighbors[k] / cols, neighbor_col = neighbors[k] % cols;
+        if (is_board_plane_set(known_board, UNKNOWN_PLANE, neighbor_row, neighbor_col))
+            equation->variables[equation->variables_number++] = neighbors[k];
+        else
+            equation->bias -= is_board_plane_set(known_board, MINE_PLANE, neighbor_row, neighbor_col);
+    }
+}
+
+/**
+ * @brief Verify the cells of a row word around changed cells, and re-derive their equations (marked pending).
+ * Neighbor counts of the whole word are computed at once, and a cell is illegal if it has more mine neighbors
+ * than its number, or fewer mine and unknown neighbors than its number.
+ * @param frontier Pointer to frontier.
+ * @param row Row index.
+ * @param word Word index in row.
+ * @return Boolean, true if all cells are legal, false otherwise (illegal_cell is set).
+ */
+bool update_row_word_equations(t_frontier *frontier, int row, int word) {
+    t_board known_board = frontier->known_board;
+    t_board changed_board = {NULL, known_board.size, known_board.words_per_row, frontier->changed_mask, NULL};
+    size_t word_index = (size_t) row * known_board.words_per_row + word;
+    uint64_t affected = frontier->changed_mask[word_index] | get_row_neighbors_mask(changed_board, 0, row, word);
+    if (!affected)
+        return true;
+    uint64_t mines[COUNT_PLANES_NUMBER], unknowns[COUNT_PLANES_NUMBER], covered[COUNT_PLANES_NUMBER];
+    uint64_t numbers[COUNT_PLANES_NUMBER];
+    count_row_neighbors(known_board, MINE_PLANE, row, word, mines);
+    count_row_neighbors(known_board, UNKNOWN_PLANE, row, word, unknowns);
+    add_counts(mines, unknowns, covered);
+    for (int i = 0; i < COUNT_PLANES_NUMBER; i++)
+        numbers[i] = BOARD_PLANE_ROW(known_board, NUMBER_PLANE + i, row)[word];
+    uint64_t revealed = BOARD_PLANE_ROW(known_board, REVEALED_PLANE, row)[word];
+    uint64_t illegal = affected & revealed & (get_greater_mask(mines, numbers) | get_greater_mask(numbers, covered));
+    if (illegal) {
+        t_board_cell illegal_cell = {row, word * BITBOARD_WORD_BITS + get_lowest_bit_index(illegal)};
+        frontier->illegal_cell = illegal_cell;
+        return false;
+    }
+    uint64_t with_equation = revealed & (unknowns[0] | unknowns[1] | unknowns[2] | unknowns[3]);
+    frontier->equations_mask[word_index] = (frontier->equations_mask[word_index] & ~affected) |
+                                           (with_equation & affected);
+    frontier->pending_mask[word_index] |= with_equation & affected;
+    for (uint64_t cells = with_equation & affected; cells; cells &= cells - 1)
+        frontier->derived_cells[frontier->derived_cells_number++] = row * known_board.size.cols +
+                                                                    word * BITBOARD_WORD_BITS +
+                                                                    get_lowest_bit_index(cells);
+    return true;
+}
+
+/**
+ * @brief Get the variable of a frontier cell, numbering it if it is first used by the laid out equations.
+ * @param frontier Pointer to frontier, while it is laid out.
+ * @param cell_index Cell index (in the rows around the laid out equations row).
+ * @return Variable index.
+ */
+int get_cell_variable(t_frontier *frontier, int cell_index) {
+    int cols = frontier->known_board.size.cols;
+    t_board_cell cell = {cell_index / cols, cell_index % cols};
+    t_variable_slot *slot = &frontier->variables_slots[(cell.row % 3) * cols + cell.col];
+    if (slot->stamp != frontier->layout_stamp || slot->row != cell.row) {
+        slot->stamp = frontier->layout_stamp;
+        slot->row = cell.row;
+        slot->variable = frontier->variables_number;
+        frontier->variables_cells[frontier->variables_number++] = cell;
+    }
+    return slot->variable;
+}
+
+void lay_out_frontier(t_frontier *frontier) {
+    int cols = frontier->known_board.size.cols;
+    ASSERT(frontier->unknown_cells == count_plane_cells(frontier->known_board, UNKNOWN_PLANE));
+    ASSERT(frontier->flagged_mines == count_plane_cells(frontier->known_board, MINE_PLANE));
+    frontier->layout_stamp++;
+    frontier->equations_number = 0;
+    frontier->variables_number = 0;
+    for (int row = 0; row < frontier->known_board.size.rows; row++)
+        for (int word = 0; word < frontier->known_board.words_per_row; word++) {
+            uint64_t cells = frontier->equations_mask[(size_t) row * frontier->known_board.words_per_row + word];
+            for (; cells; cells &= cells - 1) {
+                int cell_index = row * cols + word * BITBOARD_WORD_BITS + get_lowest_bit_index(cells);
+                t_equation *equation = &frontier->equations[frontier->equations_number++];
+                get_kept_equation(frontier, cell_index, equation);
+                for (int k = 0; k < equation->variables_number; k++)
+                    equation->variables[k] = get_cell_variable(frontier, equation->variables[k]);
+            }
+        }
+}
+
+uint64_t get_isolated_cells(t_frontier *frontier, int row, int word) {
+    t_board known_board = frontier->known_board;
+    t_board equations_board = {NULL, known_board.size, known_board.words_per_row, frontier->equations_mask, NULL};
+    uint64_t unknown_cells = BOARD_PLANE_ROW(known_board, UNKNOWN_PLANE, row)[word];
+    return unknown_cells & ~get_row_neighbors_mask(equations_board, 0, row, word);
+}
+
+void settle_component(t_frontier *frontier, t_component component) {
+    for (int i = component.first_equation; i < component.first_equation + component.equations_number; i++) {
+        t_board_cell cell = frontier->equations[i].cell;
+        size_t word_index = (size_t) cell.row * frontier->known_board.words_per_row + cell.col / BITBOARD_WORD_BITS;
+        frontier->pending_mask[word_index] &= ~((uint64_t) 1 << (cell.col % BITBOARD_WORD_BITS));
+    }
+}
+
+/**
+ * @brief Mark the plane words around changed words (the words of their cells neighbors) as affected.
+ * @param frontier Pointer to frontier.
+ * @return Void.
+ */
+void mark_affected_words(t_frontier *frontier) {
+    t_board known_board = frontier->known_board;
+    size_t changed_words_length = get_changed_words_length(known_board.size);
+    for (size_t i = 0; i < changed_words_length; i++)
+        for (uint64_t words = frontier->changed_words[i]; words; words &= words - 1) {
+            size_t word_index = i * BITBOARD_WORD_BITS + get_lowest_bit_index(words);
+            int row = (int) (word_index / known_board.words_per_row);
+            int word = (int) (word_index % known_board.words_per_row);
+            for (int neighbor_row = row - 1; neighbor_row <= row + 1; neighbor_row++)
+                for (int neighbor_word = word - 1; neighbor_word <= word + 1; neighbor_word++) {
+                    if (neighbor_row < 0 || neighbor_row >= known_board.size.rows || neighbor_word < 0 ||
+                        neighbor_word >= known_board.words_per_row)
+                        continue;
+                    size_t affected_index = (size_t) neighbor_row * known_board.words_per_row + neighbor_word;
+                    frontier->affected_words[affected_index / BITBOARD_WORD_BITS] |=
+                            (uint64_t) 1 << (affected_index % BITBOARD_WORD_BITS);
+                }
+        }
+}
+
+/**
+ * @brief Clear the changed cells and words, and the affected words, once they are updated.
+ * @param frontier Pointer to frontier.
+ * @return Void.
+ */
+void clear_changed_words(t_frontier *frontier) {
+    size_t changed_words_length = get_changed_words_length(frontier->known_board.size);
+    for (size_t i = 0; i < changed_words_length; i++) {
+        for (uint64_t words = frontier->changed_words[i]; words; words &= words - 1)
+            frontier->changed_mask[i * BITBOARD_WORD_BITS + get_lowest_bit_index(words)] = 0;
+        frontier->changed_words[i] = 0;
+        frontier->affected_words[i] = 0;
+    }
+}
+
+/**
+ * @brief Verify the cells around changed cells, and re-derive their equations (changed mask is cleared after).
+ * Only affected words are visited, in board order, so equations are derived as a scan of the whole board would.
+ * @param frontier Pointer to frontier.
+ * @return Boolean, true if all cells are legal, false otherwise (illegal_cell is set, and frontier is invalidated).
+ */
+bool update_changed_equations(t_frontier *frontier) {
+    t_board known_board = frontier->known_board;
+    size_t changed_words_length = get_changed_words_length(known_board.size);
+    bool is_legal = true;
+    mark_affected_words(frontier);
+    for (size_t i = 0; i < changed_words_length && is_legal; i++)
+        for (uint64_t words = frontier->affected_words[i]; words && is_legal; words &= words - 1) {
+            size_t word_index = i * BITBOARD_WORD_BITS + get_lowest_bit_index(words);
+            is_legal = update_row_word_equations(frontier, (int) (word_index / known_board.words_per_row),
+                                                 (int) (word_index % known_board.words_per_row));
+        }
+    clear_changed_words(frontier);
+    if (!is_legal)
+        invalidate_frontier(frontier);
+    return is_legal;
+}
+
+bool update_frontier(t_frontier *frontier, t_board board) {
+    bool is_whole_board = !frontier->is_synchronized;
+    frontier->derived_cells_number = 0;
+    if (!frontier->is_synchronized) {
+        reset_board_planes(frontier->known_board);
+        memset(frontier->equations_mask, 0, sizeof(uint64_t) * board.size.rows * board.words_per_row);
+        memset(frontier->pending_mask, 0, sizeof(uint64_t) * board.size.rows * board.words_per_row);
+        frontier->unknown_cells = board.size.rows * board.size.cols;
+        frontier->flagged_mines = 0;
+        frontier->is_synchronized = true;
+    }
+    if (find_changed_cells(frontier, board, is_whole_board))
+        return update_changed_equations(frontier);
+    return true;
+}
+
+void decide_frontier_cell(t_frontier *frontier, t_board_cell cell, bool is_mine) {
+    t_board known_board = frontier->known_board;
+    size_t word_index = (size_t) cell.row * known_board.words_per_row + cell.col / BITBOARD_WORD_BITS;
+    frontier->unknown_cells -= is_board_plane_set(known_board, UNKNOWN_PLANE, cell.row, cell.col);
+    frontier->flagged_mines += is_mine - is_board_plane_set(known_board, MINE_PLANE, cell.row, cell.col);
+    set_board_plane_cell(known_board, UNKNOWN_PLANE, cell.row, cell.col, false);
+    set_board_plane_cell(known_board, MINE_PLANE, cell.row, cell.col, is_mine);
+    frontier->changed_mask[word_index] |= (uint64_t) 1 << (cell.col % BITBOARD_WORD_BITS);
+    frontier->changed_words[word_index / BITBOARD_WORD_BITS] |= (uint64_t) 1 << (word_index % BITBOARD_WORD_BITS);
+}
+
+bool propagate_frontier_decisions(t_frontier *frontier) {
+    frontier->derived_cells_number = 0;
+    return update_changed_equations(frontier);
+}
+
+/**
+ * @brief Find union-find root of a variable (with path halving).
+ * @param parents Union-find parents array.
+ * @param variable Variable index.
+ * @return Root variable index.
+ */
+int find_root(int *parents, int variable) {
+    while (parents[variable] != variable) {
+        parents[variable] = parents[parents[variable]];
+        variable = parents[variable];
+    }
+    return variable;
+}
+
+/**
+ * @brief Unite the sets of two variables.
+ * The smaller root index becomes the parent, so roots are the first variable of every set.
+ * @param parents Union-find parents array.
+ * @param first_variable First variable index.
+ * @param second_variable Second variable index.
+ * @return Void.
+ */
+void unite_variables(int *parents, int first_variable, int second_variable) {
+    int first_root = find_root(parents, first_variable);
+    int second_root = find_root(parents, second_variable);
+    if (first_root < second_root)
+        parents[second_root] = first_root;
+    else if (second_root < first_root)
+        parents[first_root] = second_root;
+}
+
+/**
+ * @brief Label every variable with its component index, and count component sizes.
+ * Components are indexed in the order of their first variable.
+ * @param frontier Pointer to frontier.
+ * @return Void.
+ */
+void label_components(t_frontier *frontier) {
+    int *parents = frontier->union_find_parents;
+    frontier->components_number = 0;
+    for (int variable = 0; variable < frontier->variables_number; variable++)
+        parents[variable] = variable;
+    for (int i = 0; i < frontier->equations_number; i++) {
+        t_equation *equation = &frontier->equations[i];
+        for (int k = 1; k < equation->variables_number; k++)
+            unite_variables(parents, equation->variables[0], equation->variables[k]);
+    }
+    for (int variable = 0; variable < frontier->variables_number; variable++) {
+        int root = find_root(parents, variable);
+        if (root == variable) {
+            t_component empty_component = {0, 0, 0, 0, false};
+            frontier->variables_components[variable] = frontier->components_number;
+            frontier->components[frontier->components_number++] = empty_component;
+        } else
+            frontier->variables_components[variable] = frontier->variables_components[root];
+        frontier->components[frontier->variables_components[variable]].variables_number++;
+    }
+    for (int i = 0; i < frontier->equations_number; i++) {
+        int component = frontier->variables_components[frontier->equations[i].variables[0]];
+        frontier->components[component].equations_number++;
+        frontier->components[component].is_pending |= frontier->equations[i].is_pending;
+    }
+}
+
+void find_components(t_frontier *frontier) {
+    label_components(frontier);
+    int next_variable = 0, next_equation = 0;
+    for (int i = 0; i < frontier->components_number; i++) {
+        t_component *component = &frontier->components[i];
+        component->first_variable = next_variable;
+        component->first_equation = next_equation;
+        next_variable += component->variables_number;
+        next_equation += component->equations_number;
+        // Reused as insertion counters below.
+        component->variables_number = 0;
+        component->equations_number = 0;
+    }
+    for (int variable = 0; variable < frontier->variables_number; variable++) {
+        t_component *component = &frontier->components[frontier->variables_components[variable]];
+        int renumbered = component->first_variable + component->variables_number++;
+        t_board_cell cell = frontier->variables_cells[variable];
+        frontier->renumbered_variables[variable] = renumbered;
+        frontier->variables_cells_scratch[renumbered] = cell;
+    }
+    for (int i = 0; i < frontier->equations_number; i++) {
+        t_equation equation = frontier->equations[i];
+        t_component *component = &frontier->components[frontier->variables_components[equation.variables[0]]];
+        for (int k = 0; k < equation.variables_number; k++)
+            equation.variables[k] = frontier->renumbered_variables[equation.variables[k]];
+        frontier->equations_scratch[component->first_equation + component->equations_number++] = equation;
+    }
+    t_equation *equations = frontier->equations;
+    frontier->equations = frontier->equations_scratch;
+    frontier->equations_scratch = equations;
+    t_board_cell *variables_cells = frontier->variables_cells;
+    frontier->variables_cells = frontier->variables_cells_scratch;
+    frontier->variables_cells_scratch = variables_cells;
+}
@@ -0,0 +1,207 @@
+/**************************************************************************************************
+ * @file frontier.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for frontier module.
+ * Exports the unknown cells equations (one for every numeric cell with unknown neighbors),
+ * the mapping between variables and board cells, and the split of equations into independent components.
+ * Frontier keeps its equations between turns, and re-derives only the equations around changed cells.
+ * Board-size state is kept in bitplanes only, other buffers are touched in the size of the frontier.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_FRONTIER_H
+#define MINESWEEPERSOLVER_FRONTIER_H
+
+#include <stdbool.h>
+#include "error_codes.h"
+#include "board.h"
+
+#define NEIGHBORS_NUMBER 8
+
+/**
+ * Struct for a single equation, sum of variables (unknown neighbors) equals the missing mines.
+ */
+struct equation {
+    t_board_cell cell;                  // The numeric cell of equation.
+    int variables[NEIGHBORS_NUMBER];    // Variable indexes of unknown neighbors (cell indexes in kept equations).
+    int variables_number;
+    int bias;                           // Number of missing mines around cell.
+    bool is_pending;                    // True if equation has changed since its component was last solved.
+};
+typedef struct equation t_equation;
+
+/**
+ * Struct for an independent component, equations that share no variable with other components.
+ * Component equations and variables have contiguous indexes.
+ */
+struct component {
+    int first_equation;
+    int equations_number;
+    int first_variable;
+    int variables_number;
+    bool is_pending;    // True if one of component equations has changed since it was last solved.
+};
+typedef struct component t_component;
+
+/**
+ * Struct for the variable of a cell in the rows around laid out equations.
+ */
+struct variable_slot {
+    int stamp;      // Slot is empty unless stamp is the layout stamp.
+    int row;        // Slot is empty unless row is the cell row (rows share slots by row modulo 3).
+    int variable;
+};
+typedef struct variable_slot t_variable_slot;
+
+/**
+ * Struct for frontier (unknown cells with numeric neighbors) equations system.
+ * All buffers are allocated once and reused for every turn. Board-size state is kept in bitplanes, and kept equations
+ * are derived from known board when needed, so the buffers in the size of board cells are touched only as deep as the
+ * frontier (equations, variables and components are indexed by their order).
+ */
+struct frontier {
+    int unknown_cells;                  // Number of unknown cells in known board (kept by changes).
+    int flagged_mines;                  // Number of cells in known board marked as mines (kept by changes).
+    t_board_cell illegal_cell;          // Numeric cell that contradicts its neighbors, if board is illegal.
+    bool is_synchronized;               // False if kept state is not derived from known board (full rebuild).
+    t_board known_board;                // Bitplanes the kept equations were derived from (no cells array).
+    uint64_t *equations_mask;           // Bitplane of cells with a kept equation.
+    uint64_t *pending_mask;             // Bitplane of kept equations changed since their component was last solved.
+    uint64_t *changed_mask;             // Scratch, bitplane of cells changed since last update.
+    uint64_t *changed_words;            // Scratch, bit of every changed_mask word that has changed cells.
+    uint64_t *affected_words;           // Scratch, bit of every plane word that has cells around changed cells.
+    int *derived_cells;                 // Cells whose equation was re-derived by last update.
+    int derived_cells_number;
+    t_equation *equations;
+    int equations_number;
+    t_board_cell *variables_cells;      // Mapping between variable indexes to board cells.
+    int variables_number;
+    t_variable_slot *variables_slots;   // Scratch, variables of the 3 rows around laid out equations (3 rows of cols).
+    int layout_stamp;
+    t_component *components;
+    int components_number;
+    int *union_find_parents;            // Scratch, variable index to parent variable index.
+    int *variables_components;          // Scratch, variable index to component index.
+    int *renumbered_variables;          // Scratch, variable index to its component ordered index.
+    t_equation *equations_scratch;
+    t_board_cell *variables_cells_scratch;
+};
+typedef struct frontier t_frontier;
+
+/**
+ * @brief Initialize frontier buffers.
+ * @param frontier Pointer to frontier.
+ * @param board_size Board size.
+ * @return Error code.
+ */
+t_error_code initialize_frontier(t_frontier *frontier, t_board_size board_size);
+
+/**
+ * @brief Free frontier buffers.
+ * @param frontier Pointer to frontier.
+ * @return Void.
+ */
+void free_frontier(t_frontier *frontier);
+
+/**
+ * @brief Update kept frontier equations to a board.
+ * Board bitplanes are compared against the known board, and only the equations of changed cells and their
+ * neighbors are re-derived (and marked pending). Legality is verified around changed cells only, meaning every such
+ * numeric cell has at most its number of mine neighbors, and enough unknowns for the rest. Neighbor counts are
+ * computed 64 cells at a time, from shifted bitplane words.
+ * Only the words marked in the board changed words are compared (and their marks are cleared), so an update costs as
+ * much as the change. A board with no changed words bitmap, or a frontier that is not synchronized, is compared whole.
+ * @param frontier Pointer to frontier.
+ * @param board The board.
+ * @return Boolean, true if board is legal, false otherwise (illegal_cell is set, and frontier is invalidated).
+ */
+bool update_frontier(t_frontier *frontier, t_board board);
+
+/**
+ * @brief Apply a deduced cell to known board, before the board itself is updated.
+ * A mine is flagged, and a clear cell is no longer unknown (its number is not known yet), so it is left out of
+ * the equations around it. Decisions take effect once propagated.
+ * @param frontier Pointer to frontier.
+ * @param cell Deduced cell (unknown in known board).
+ * @param is_mine Whether cell is a mine.
+ * @return Void.
+ */
+void decide_frontier_cell(t_frontier *frontier, t_board_cell cell, bool is_mine);
+
+/**
+ * @brief Re-derive the equations around decided cells (and mark them pending), as done for changed cells.
+ * The next board update brings back the real value of decided cells.
+ * @param frontier Pointer to frontier.
+ * @return Boolean, true if board is still legal, false otherwise (illegal_cell is set, and frontier is invalidated).
+ */
+bool propagate_frontier_decisions(t_frontier *frontier);
+
+/**
+ * @brief Lay out kept equations in board order as frontier equations, and map variables to board cells.
+ * Variables are numbered on first use, so the result is identical to a build from scratch. Variables of a cell are
+ * looked up in the slots of the 3 rows around the equations row, so no board-size map is needed.
+ * @param frontier Pointer to updated frontier.
+ * @return Void.
+ */
+void lay_out_frontier(t_frontier *frontier);
+
+/**
+ * @brief Get the neighbor cell indexes of a cell (in board order).
+ * @param board_size Board size.
+ * @param cell_index Cell index.
+ * @param neighbors Neighbor cell indexes to set.
+ * @return Number of neighbors.
+ */
+int get_cell_neighbors(t_board_size board_size, int cell_index, int neighbors[NEIGHBORS_NUMBER]);
+
+/**
+ * @brief Get the kept equation of an equation cell, derived from known board.
+ * Every change of known board re-derives the equations around it, so the equation is the one that was last derived.
+ * @param frontier Pointer to updated frontier.
+ * @param cell_index Cell index (with a kept equation).
+ * @param equation Equation to set (variables are cell indexes).
+ * @return Void.
+ */
+void get_kept_equation(t_frontier *frontier, int cell_index, t_equation *equation);
+
+/**
+ * @brief Check whether a cell has a kept equation.
+ * @param frontier Pointer to frontier.
+ * @param cell_index Cell index.
+ * @return Boolean, true if cell has a kept equation.
+ */
+bool has_kept_equation(t_frontier *frontier, int cell_index);
+
+/**
+ * @brief Get the isolated cells of a row word, unknown cells that are not a variable of any kept equation.
+ * @param frontier Pointer to updated frontier.
+ * @param row Row index.
+ * @param word Word index in row.
+ * @return Mask of isolated cells in word.
+ */
+uint64_t get_isolated_cells(t_frontier *frontier, int row, int word);
+
+/**
+ * @brief Invalidate kept frontier state, so the next update rebuilds all equations.
+ * @param frontier Pointer to frontier.
+ * @return Void.
+ */
+void invalidate_frontier(t_frontier *frontier);
+
+/**
+ * @brief Mark the equations of a component as solved, so the component is skipped while they are unchanged.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @return Void.
+ */
+void settle_component(t_frontier *frontier, t_component component);
+
+/**
+ * @brief Split frontier into independent components (connected by shared variables), using union-find.
+ * Variables and equations are renumbered, so every component has contiguous indexes.
+ * @param frontier Pointer to built frontier.
+ * @return Void.
+ */
+void find_components(t_frontier *frontier);
+
+#endif //MINESWEEPERSOLVER_FRONTIER_H
@@ -0,0 +1,58 @@
+/**************************************************************************************************
+ * @file headless_commander.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief headless_commander module implements commander services (and board update) over the
+ * in-process simulator, instead of Minesweeper X window. It replaces commander and board modules
+ * in HEADLESS builds, so the solver runs on any OS, without screenshots or cursor sleeps.
+ * Like Minesweeper X window, the simulated game is a single process-wide resource.
+ **************************************************************************************************/
+#include <time.h>
+#include "error_codes.h"
+#include "commander.h"
+#include "board.h"
+#include "logger.h"
+#include "simulator.h"
+#include "solver.h"
+
+/**
+ * The simulated game, played instead of Minesweeper X window.
+ */
+static t_game simulated_game = {0};
+
+/**
+ * Generator of game seeds, every restart plays a new game.
+ */
+static t_random_generator seeds_generator;
+
+t_error_code raise_minesweeper() {
+    seed_random_generator(&seeds_generator, (uint64_t) time(NULL));
+    return RETURN_CODE_SUCCESS;
+}
+
+t_error_code execute_moves(t_moves moves) {
+    return simulate_moves(&simulated_game, moves);
+}
+
+t_error_code set_minesweeper_level(t_level level) {
+    free_game(&simulated_game);
+    return initialize_game(&simulated_game, level.board_size, level.number_of_mines,
+                           get_random_number(&seeds_generator));
+}
+
+t_error_code restart_game(t_level level) {
+    (void) level; // The simulated game keeps its level, only a new seed is drawn.
+    reset_game(&simulated_game, get_random_number(&seeds_generator));
+    return RETURN_CODE_SUCCESS;
+}
+
+t_error_code update_board(t_solver *solver, t_board board, t_game_status *game_status,
+                          t_cell_rect game_status_rect) {
+    (void) solver; // The simulated board is read as is, with no screenshot to calibrate or game status icon to find.
+    (void) game_status_rect;
+    update_board_from_game(&simulated_game, board, game_status);
+    if (*game_status != GAME_ON)
+        return RETURN_CODE_SUCCESS;
+    return log_board(board);
+}
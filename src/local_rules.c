@@ -0,0 +1,133 @@
+/**************************************************************************************************
+ * @file local_rules.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief local rules module, deduces cells out of single equations before any matrix is built.
+ * Most turns are solved by the two classic rules (all flagged, or all unknowns are mines), so a worklist of the
+ * changed equations is propagated first, and elimination runs only once it deduces nothing.
+**************************************************************************************************/
+#include <stdlib.h>
+#include "bitboard.h"
+#include "local_rules.h"
+
+t_error_code initialize_local_rules(t_local_rules *rules, t_board_size board_size) {
+    int cells_number = board_size.rows * board_size.cols;
+    int words_per_row = get_words_per_row(board_size.cols);
+    t_board marks = {NULL, board_size, words_per_row, NULL, NULL};
+    rules->marks = marks;
+    rules->decided_number = 0;
+    rules->marks.planes = (uint64_t *) calloc((size_t) board_size.rows * words_per_row * MARKS_NUMBER,
+                                              sizeof(uint64_t));
+    rules->queue = (int *) malloc(sizeof(int) * cells_number);
+    rules->decided_cells = (int *) malloc(sizeof(int) * cells_number);
+    rules->decided_mines = (bool *) malloc(sizeof(bool) * cells_number);
+    if (!rules->marks.planes || !rules->queue || !rules->decided_cells || !rules->decided_mines) {
+        free_local_rules(rules);
+        return ERROR_LOCAL_RULES_MEMORY_ALLOC;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_local_rules(t_local_rules *rules) {
+    free(rules->marks.planes);
+    free(rules->queue);
+    free(rules->decided_cells);
+    free(rules->decided_mines);
+    rules->marks.planes = NULL;
+    rules->queue = NULL;
+    rules->decided_cells = NULL;
+    rules->decided_mines = NULL;
+}
+
+/**
+ * @brief Check whether a cell is marked.
+ * @param rules Pointer to local rules.
+ * @param mark The mark.
+ * @param cell_index Cell index.
+ * @return Boolean, true if cell is marked.
+ */
+bool is_cell_marked(t_local_rules *rules, t_local_mark mark, int cell_index) {
+    int cols = rules->marks.size.cols;
+    return is_board_plane_set(rules->marks, (t_board_plane) mark, cell_index / cols, cell_index % cols);
+}
+
+/**
+ * @brief Mark (or unmark) a cell.
+ * @param rules Pointer to local rules.
+ * @param mark The mark.
+ * @param cell_index Cell index.
+ * @param is_marked Whether cell is marked.
+ * @return Void.
+ */
+void mark_cell(t_local_rules *rules, t_local_mark mark, int cell_index, bool is_marked) {
+    int cols = rules->marks.size.cols;
+    set_board_plane_cell(rules->marks, (t_board_plane) mark, cell_index / cols, cell_index % cols, is_marked);
+}
+
+/**
+ * @brief Add an equation cell to worklist, unless it is already there.
+ * @param rules Pointer to local rules.
+ * @param frontier Pointer to frontier.
+ * @param queue_end Pointer to worklist end (total number of ever queued cells).
+ * @param cell_index Equation cell index.
+ * @return Void.
+ */
+void queue_equation(t_local_rules *rules, t_frontier *frontier, int *queue_end, int cell_index) {
+    int cells_number = frontier->known_board.size.rows * frontier->known_board.size.cols;
+    if (is_cell_marked(rules, QUEUED_MARK, cell_index))
+        return;
+    mark_cell(rules, QUEUED_MARK, cell_index, true);
+    rules->queue[(*queue_end)++ % cells_number] = cell_index;
+}
+
+/**
+ * @brief Decide a cell, and queue the equations around it.
+ * @param rules Pointer to local rules.
+ * @param frontier Pointer to frontier.
+ * @param queue_end Pointer to worklist end.
+ * @param cell_index Decided cell index.
+ * @param is_mine Whether cell is a mine.
+ * @return Void.
+ */
+void decide_cell(t_local_rules *rules, t_frontier *frontier, int *queue_end, int cell_index, bool is_mine) {
+    int neighbors[NEIGHBORS_NUMBER];
+    int neighbors_number = get_cell_neighbors(frontier->known_board.size, cell_index, neighbors);
+    mark_cell(rules, DECIDED_MARK, cell_index, true);
+    mark_cell(rules, DECIDED_MINE_MARK, cell_index, is_mine);
+    rules->decided_cells[rules->decided_number] = cell_index;
+    rules->decided_mines[rules->decided_number++] = is_mine;
+    for (int k = 0; k < neighbors_number; k++)
+        if (has_kept_equation(frontier, neighbors[k]))
+            queue_equation(rules, frontier, queue_end, neighbors[k]);
+}
+
+int apply_local_rules(t_local_rules *rules, t_frontier *frontier) {
+    int cells_number = frontier->known_board.size.rows * frontier->known_board.size.cols;
+    int queue_start = 0, queue_end = 0;
+    t_equation equation;
+    for (int i = 0; i < rules->decided_number; i++) {
+        mark_cell(rules, DECIDED_MARK, rules->decided_cells[i], false);
+        mark_cell(rules, DECIDED_MINE_MARK, rules->decided_cells[i], false);
+    }
+    rules->decided_number = 0;
+    for (int i = 0; i < frontier->derived_cells_number; i++)
+        queue_equation(rules, frontier, &queue_end, frontier->derived_cells[i]);
+    while (queue_start < queue_end) {
+        int cell_index = rules->queue[queue_start++ % cells_number];
+        mark_cell(rules, QUEUED_MARK, cell_index, false);
+        get_kept_equation(frontier, cell_index, &equation);
+        int bias = equation.bias, unknowns = equation.variables_number;
+        for (int k = 0; k < equation.variables_number; k++)
+            if (is_cell_marked(rules, DECIDED_MARK, equation.variables[k])) {
+                bias -= is_cell_marked(rules, DECIDED_MINE_MARK, equation.variables[k]);
+                unknowns--;
+            }
+        if (unknowns == 0 || (bias != 0 && bias != unknowns))
+            continue;
+        for (int k = 0; k < equation.variables_number; k++)
+            if (!is_cell_marked(rules, DECIDED_MARK, equation.variables[k]))
+                decide_cell(rules, frontier, &queue_end, equation.variables[k], bias != 0);
+    }
+    return rules->decided_number;
+}
@@ -0,0 +1,67 @@
+/**************************************************************************************************
+ * @file local_rules.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for local rules module, exports the single equation deductions pass.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_LOCAL_RULES_H
+#define MINESWEEPERSOLVER_LOCAL_RULES_H
+
+#include <stdbool.h>
+#include "error_codes.h"
+#include "board.h"
+#include "frontier.h"
+
+/**
+ * Enum for the bitplanes of local rules marks.
+ */
+typedef enum {
+    QUEUED_MARK,        // Equation cells while they are in worklist.
+    DECIDED_MARK,       // Cells decided by current pass.
+    DECIDED_MINE_MARK,  // Cells decided as mines by current pass.
+    MARKS_NUMBER
+} t_local_mark;
+
+/**
+ * Struct for local rules state.
+ * Board-size state is kept in mark bitplanes only, and the state of an equation is its kept equation less the cells
+ * decided around it, so nothing is indexed by cell. Marks of a pass are cleared by the next pass.
+ */
+struct local_rules {
+    t_board marks;              // MARKS_NUMBER bitplanes of board size (no cells array).
+    int *queue;                 // Worklist of equation cells (cyclic).
+    int *decided_cells;         // Cells decided this turn, in order of decision.
+    bool *decided_mines;        // Whether every decided cell (by order of decision) is a mine.
+    int decided_number;
+};
+typedef struct local_rules t_local_rules;
+
+/**
+ * @brief Initialize local rules buffers.
+ * @param rules Pointer to local rules.
+ * @param board_size Board size.
+ * @return Error code.
+ */
+t_error_code initialize_local_rules(t_local_rules *rules, t_board_size board_size);
+
+/**
+ * @brief Free local rules buffers.
+ * @param rules Pointer to local rules.
+ * @return Void.
+ */
+void free_local_rules(t_local_rules *rules);
+
+/**
+ * @brief Deduce cells by the two single equation rules, propagated over a worklist of equations.
+ * If a number equals its flagged neighbors the rest are clear, and if it equals its flagged and unknown neighbors
+ * they are all mines. The worklist starts with the equations re-derived by last frontier update (unchanged equations
+ * had nothing to deduce), and every decided cell queues the equations around it with updated counts,
+ * so the pass costs as much as the change.
+ * @param rules Pointer to local rules.
+ * @param frontier Pointer to updated frontier (kept equations are used, no layout is needed).
+ * @return Number of decided cells (decided cells and decided mines are set).
+ */
+int apply_local_rules(t_local_rules *rules, t_frontier *frontier);
+
+#endif //MINESWEEPERSOLVER_LOCAL_RULES_H
@@ -5,9 +5,11 @@
  * @date 25.5.2020
  * @brief logger module which is responsible for logging MinesweeperSolver activity.
  * Logger will save log files under a special logging directory that is creates if needed.
- * All logging is done using upper bounds for output size, to avoid heap memory allocation.
+ * All logging is done using upper bounds for output size, to avoid heap memory allocation. A printout that exceeds
+ * its bound is truncated (e.g. the board of a custom level), and stops iterating once its buffer is full.
 **************************************************************************************************/
 #include <stdio.h>
+#include <stdarg.h>
 #include <time.h>
 #include <string.h>
 #include <stdbool.h>
@@ -18,9 +20,14 @@
 #include "logger.h"
 
 #define LOGGING_DIRECTORY_NAME "Logs"
+#ifdef _WIN32
+#define PATH_SEPARATOR "\\"
+#else
+#define PATH_SEPARATOR "/"
+#endif
 #define MKDIR_MODE 0700
 #define MATRIX_MAX_PRINTOUT_SIZE 8192
-#define VARIABLES_MAP_PRINTOUT_SIZE 4096
+#define VARIABLES_PRINTOUT_SIZE 4096
 #define MOVES_MAX_PRINTOUT_SIZE 2048
 #define BOARD_MAX_PRINTOUT_SIZE 2048
 #define HISTOGRAM_MAX_PRINTOUT_SIZE 512
@@ -40,7 +47,7 @@
 #define HISTOGRAM_TAG DEBUG_TAG
 #define BOARD_TAG RUNTIME_TAG
 #define MATRIX_TAG DEBUG_TAG
-#define VARIABLES_MAP_TAG DEBUG_TAG
+#define VARIABLES_TAG DEBUG_TAG
 #define ILLEGAL_CELL_TAG DEBUG_TAG
 
 /**
@@ -66,10 +73,13 @@ t_error_code write_log(const char *tag, const char *message) {
 
 /**
  * @brief Is logging required for a specific tag.
+ * Nothing is logged before log is opened (e.g. in benchmark runs).
  * @param tag Tag string (RUNTIME_TAG or DEBUG_TAG).
  * @return boolan, true is logging is needed, false otherwise.
  */
 bool is_logging_needed(const char *tag) {
+    if (!log_file)
+        return false;
     if (!strncmp(tag, DEBUG_TAG, sizeof(tag)) && !DEBUG_LOGGING)
         return false;
     if (!RUNTIME_LOGGING)
@@ -77,19 +87,42 @@ bool is_logging_needed(const char *tag) {
     return true;
 }
 
+/**
+ * @brief Append formatted text to a printout buffer, truncating it once the buffer is full.
+ * @param buffer Printout buffer.
+ * @param buffer_size Size of buffer.
+ * @param writing_length Pointer to current writing length into buffer (at most buffer_size - 1).
+ * @param format Format string, followed by its arguments.
+ * @return Boolean, true if the buffer has room left, false once it is full.
+ */
+bool append_to_printout(char *buffer, size_t buffer_size, size_t *writing_length, const char *format, ...) {
+    if (*writing_length + 1 >= buffer_size)
+        return false;
+    va_list arguments;
+    va_start(arguments, format);
+    int written = vsnprintf(buffer + *writing_length, buffer_size - *writing_length, format, arguments);
+    va_end(arguments);
+    if (written < 0)
+        return false;
+    *writing_length += (size_t) written;
+    if (*writing_length + 1 >= buffer_size) {
+        *writing_length = buffer_size - 1;
+        return false;
+    }
+    return true;
+}
+
 t_error_code log_moves(t_moves moves) {
     if (!is_logging_needed(MOVE_TAG))
         return RETURN_CODE_SUCCESS;
     char moves_buffer[MOVES_MAX_PRINTOUT_SIZE];
-    size_t current_buffer_length = snprintf(moves_buffer, MOVES_MAX_PRINTOUT_SIZE,
-                                            "Chosen moves: Number of moves - %d\n",
-                                            moves.number_of_moves);
-    for (int i = 0; i < moves.number_of_moves; i++) {
-        current_buffer_length += snprintf(moves_buffer + current_buffer_length,
-                                          MOVES_MAX_PRINTOUT_SIZE - current_buffer_length,
-                                          "Move (%d, %d), is mine - %d\n",
-                                          moves.moves[i].cell.row, moves.moves[i].cell.col, moves.moves[i].is_mine);
-    }
+    size_t current_buffer_length = 0;
+    bool has_room = append_to_printout(moves_buffer, MOVES_MAX_PRINTOUT_SIZE, &current_buffer_length,
+                                       "Chosen moves: Number of moves - %d\n", moves.number_of_moves);
+    for (int i = 0; i < moves.number_of_moves && has_room; i++)
+        has_room = append_to_printout(moves_buffer, MOVES_MAX_PRINTOUT_SIZE, &current_buffer_length,
+                                      "Move (%d, %d), is mine - %d\n",
+                                      moves.moves[i].cell.row, moves.moves[i].cell.col, moves.moves[i].is_mine);
     t_error_code error_code = write_log(MOVE_TAG, moves_buffer);
     if (error_code)
         return error_code;
@@ -138,13 +171,11 @@ t_error_code log_histogram(t_board_cell cell, t_color_histogram histogram) {
         return RETURN_CODE_SUCCESS;
     char histogram_buffer[HISTOGRAM_MAX_PRINTOUT_SIZE];
     size_t current_buffer_length = 0;
-    current_buffer_length += snprintf(histogram_buffer, HISTOGRAM_MAX_PRINTOUT_SIZE,
-                                      "Histogram for cell (%d, %d):\n Histogram: ",
-                                      cell.row, cell.col);
-    for (int i = 0; i < NUMBER_OF_COLORS; i++) {
-        current_buffer_length += snprintf(histogram_buffer + current_buffer_length,
-                                          HISTOGRAM_MAX_PRINTOUT_SIZE - current_buffer_length, "%.3f ", histogram[i]);
-    }
+    bool has_room = append_to_printout(histogram_buffer, HISTOGRAM_MAX_PRINTOUT_SIZE, &current_buffer_length,
+                                       "Histogram for cell (%d, %d):\n Histogram: ", cell.row, cell.col);
+    for (int i = 0; i < NUMBER_OF_COLORS && has_room; i++)
+        has_room = append_to_printout(histogram_buffer, HISTOGRAM_MAX_PRINTOUT_SIZE, &current_buffer_length,
+                                      "%.3f ", histogram[i]);
     t_error_code error_code = write_log(HISTOGRAM_TAG, histogram_buffer);
     if (error_code)
         return error_code;
@@ -161,21 +192,22 @@ t_error_code log_histogram(t_board_cell cell, t_color_histogram histogram) {
  * @param buffer_size Maximal size of writing left to buffer.
  * @param is_double Boolean, True if matrix type is double, False otherwise.
  * @param cell Matrix cell to print.
- * @return Void.
+ * @return Boolean, true if the buffer has room left, false once it is full.
  */
-void print_single_cell(char *buffer, t_data double_data, t_matrix_size matrix_size, t_board integer_board,
+bool print_single_cell(char *buffer, t_data double_data, t_matrix_size matrix_size, t_cell_type *integer_board,
                        size_t *writing_length, size_t buffer_size, bool is_double, t_matrix_cell cell) {
     if (is_double) {
         t_matrix double_matrix = {double_data, matrix_size};
-        *writing_length += snprintf(buffer + *writing_length, buffer_size - *writing_length,
-                                    "%.3f ", MATRIX_CELL(double_matrix, cell.row, cell.col));
-    } else
-        *writing_length += snprintf(buffer + *writing_length, buffer_size - *writing_length,
-                                    "%d ", BOARD_CELL(integer_board, cell.row, cell.col));
+        return append_to_printout(buffer, buffer_size, writing_length, "%.3f ",
+                                  MATRIX_CELL(double_matrix, cell.row, cell.col));
+    }
+    t_board board = {integer_board, matrix_size};
+    return append_to_printout(buffer, buffer_size, writing_length, "%d ", BOARD_CELL(board, cell.row, cell.col));
 }
 
 /**
  * @brief Print a matrix (integer board or double matrix) to log.
+ * Printing stops once the buffer is full, so a large board costs no more than the buffer.
  * @param buffer Printout logging buffer (string).
  * @param matrix Void pointer to matrix (double or integer type).
  * @param writing_length Current writing length into buffer.
@@ -188,28 +220,29 @@ void print_single_cell(char *buffer, t_data double_data, t_matrix_size matrix_si
 void write_board_matrix_to_buffer(char *buffer, void *matrix, size_t *writing_length,
                                   size_t buffer_size, bool is_double, bool is_transpose, t_matrix_size matrix_size) {
     t_data double_data = NULL;
-    t_board integer_board = NULL;
+    t_cell_type *integer_board = NULL;
+    bool has_room = *writing_length + 1 < buffer_size;
     if (is_double)
         double_data = (t_data) matrix;
     else
-        integer_board = (t_board) matrix;
+        integer_board = (t_cell_type *) matrix;
     if (is_transpose)
-        for (int row = 0; row < matrix_size.rows; row++) {
-            for (int col = 0; col < matrix_size.cols; col++) {
+        for (int row = 0; row < matrix_size.rows && has_room; row++) {
+            for (int col = 0; col < matrix_size.cols && has_room; col++) {
                 t_matrix_cell cell = {row, col};
-                print_single_cell(buffer, double_data, matrix_size, integer_board,
-                                  writing_length, buffer_size, is_double, cell);
+                has_room = print_single_cell(buffer, double_data, matrix_size, integer_board,
+                                             writing_length, buffer_size, is_double, cell);
             }
-            *writing_length += snprintf(buffer + *writing_length, buffer_size - *writing_length, "\n");
+            has_room = has_room && append_to_printout(buffer, buffer_size, writing_length, "\n");
         }
     else
-        for (int col = 0; col < matrix_size.cols; col++) {
-            for (int row = 0; row < matrix_size.rows; row++) {
+        for (int col = 0; col < matrix_size.cols && has_room; col++) {
+            for (int row = 0; row < matrix_size.rows && has_room; row++) {
                 t_matrix_cell cell = {row, col};
-                print_single_cell(buffer, double_data, matrix_size, integer_board,
-                                  writing_length, buffer_size, is_double, cell);
+                has_room = print_single_cell(buffer, double_data, matrix_size, integer_board,
+                                             writing_length, buffer_size, is_double, cell);
             }
-            *writing_length += snprintf(buffer + *writing_length, buffer_size - *writing_length, "\n");
+            has_room = has_room && append_to_printout(buffer, buffer_size, writing_length, "\n");
         }
 }
 
@@ -218,9 +251,9 @@ t_error_code log_board(t_board board) {
         return RETURN_CODE_SUCCESS;
     char board_buffer[BOARD_MAX_PRINTOUT_SIZE];
     size_t current_length = 0;
-    current_length += snprintf(board_buffer, BOARD_MAX_PRINTOUT_SIZE, "Board detected:\n");
-    write_board_matrix_to_buffer(board_buffer, board, &current_length, BOARD_MAX_PRINTOUT_SIZE, false, false,
-                                 board_size);
+    append_to_printout(board_buffer, BOARD_MAX_PRINTOUT_SIZE, &current_length, "Board detected:\n");
+    write_board_matrix_to_buffer(board_buffer, board.cells, &current_length, BOARD_MAX_PRINTOUT_SIZE, false, false,
+                                 board.size);
     t_error_code error_code = write_log(BOARD_TAG, board_buffer);
     if (error_code)
         return error_code;
@@ -232,7 +265,7 @@ t_error_code log_matrix(t_matrix matrix, const char *message) {
         return RETURN_CODE_SUCCESS;
     char matrix_buffer[MATRIX_MAX_PRINTOUT_SIZE];
     size_t current_length = 0;
-    current_length += snprintf(matrix_buffer, MATRIX_MAX_PRINTOUT_SIZE, "%s\n", message);
+    append_to_printout(matrix_buffer, MATRIX_MAX_PRINTOUT_SIZE, &current_length, "%s\n", message);
     write_board_matrix_to_buffer(matrix_buffer, matrix.data, &current_length, MATRIX_MAX_PRINTOUT_SIZE, true, true,
                                  matrix.size);
     t_error_code error_code = write_log(MATRIX_TAG, matrix_buffer);
@@ -241,15 +274,36 @@ t_error_code log_matrix(t_matrix matrix, const char *message) {
     return RETURN_CODE_SUCCESS;
 }
 
-t_error_code log_variables_map(t_matrix variables_map) {
-    if (!is_logging_needed(VARIABLES_MAP_TAG))
+t_error_code log_integer_matrix(t_integer_matrix matrix, const char *message) {
+    if (!is_logging_needed(MATRIX_TAG))
+        return RETURN_CODE_SUCCESS;
+    char matrix_buffer[MATRIX_MAX_PRINTOUT_SIZE];
+    size_t current_length = 0;
+    append_to_printout(matrix_buffer, MATRIX_MAX_PRINTOUT_SIZE, &current_length, "%s\n", message);
+    bool has_room = current_length + 1 < MATRIX_MAX_PRINTOUT_SIZE;
+    for (int row = 0; row < matrix.size.rows && has_room; row++) {
+        for (int col = 0; col < matrix.size.cols && has_room; col++)
+            has_room = append_to_printout(matrix_buffer, MATRIX_MAX_PRINTOUT_SIZE, &current_length, "%lld ",
+                                          (long long) INTEGER_MATRIX_CELL(matrix, row, col));
+        has_room = has_room && append_to_printout(matrix_buffer, MATRIX_MAX_PRINTOUT_SIZE, &current_length, "\n");
+    }
+    t_error_code error_code = write_log(MATRIX_TAG, matrix_buffer);
+    if (error_code)
+        return error_code;
+    return RETURN_CODE_SUCCESS;
+}
+
+t_error_code log_variables_cells(const t_board_cell *variables_cells, int variables_number) {
+    if (!is_logging_needed(VARIABLES_TAG))
         return RETURN_CODE_SUCCESS;
-    char printout_buffer[VARIABLES_MAP_PRINTOUT_SIZE];
+    char printout_buffer[VARIABLES_PRINTOUT_SIZE];
     size_t current_length = 0;
-    current_length += snprintf(printout_buffer, VARIABLES_MAP_PRINTOUT_SIZE, "Variables indexes map:\n");
-    write_board_matrix_to_buffer(printout_buffer, variables_map.data, &current_length, VARIABLES_MAP_PRINTOUT_SIZE,
-                                 true, false, board_size);
-    t_error_code error_code = write_log(VARIABLES_MAP_TAG, printout_buffer);
+    bool has_room = append_to_printout(printout_buffer, VARIABLES_PRINTOUT_SIZE, &current_length,
+                                       "Variables cells: Number of variables - %d\n", variables_number);
+    for (int i = 0; i < variables_number && has_room; i++)
+        has_room = append_to_printout(printout_buffer, VARIABLES_PRINTOUT_SIZE, &current_length,
+                                      "Variable %d - (%d, %d)\n", i, variables_cells[i].row, variables_cells[i].col);
+    t_error_code error_code = write_log(VARIABLES_TAG, printout_buffer);
     if (error_code)
         return error_code;
     return RETURN_CODE_SUCCESS;
@@ -275,7 +329,8 @@ t_error_code open_log() {
     time(&now);
     info = localtime(&now);
     char file_name_buffer[FILE_NAME_BUFFER_SIZE];
-    size_t written_bytes = snprintf(file_name_buffer, FILE_NAME_BUFFER_SIZE, "%s\\", LOGGING_DIRECTORY_NAME);
+    size_t written_bytes = snprintf(file_name_buffer, FILE_NAME_BUFFER_SIZE, "%s" PATH_SEPARATOR,
+                                    LOGGING_DIRECTORY_NAME);
     written_bytes += strftime(file_name_buffer + written_bytes, FILE_NAME_BUFFER_SIZE - written_bytes,
                               "%Y%m%d-%H%M%S.log", info);
     if (!written_bytes)
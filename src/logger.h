@@ -29,11 +29,21 @@ t_error_code log_board(t_board board);
 t_error_code log_matrix(t_matrix matrix, const char *message);
 
 /**
- * @brief Log variables map, mapping between board cell to variable index in the matrix.
- * @param variable_map Variables map pointer.
+ * @brief Log the integer matrix (of unknown cells linear equations).
+ * @param matrix The integer matrix
+ * @param message String of a logging message, representing matrix logging stage.
+ * @return Error code of logging.
+ */
+t_error_code log_integer_matrix(t_integer_matrix matrix, const char *message);
+
+/**
+ * @brief Log frontier variables, mapping between variable index in the matrix to board cell.
+ * Printout is truncated once its buffer is full.
+ * @param variables_cells Board cell of every variable.
+ * @param variables_number Number of variables.
  * @return Error code of logging.
  */
-t_error_code log_variables_map(t_matrix variables_map);
+t_error_code log_variables_cells(const t_board_cell *variables_cells, int variables_number);
 
 /**
  * @brief Log chosen game moves.
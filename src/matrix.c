@@ -6,132 +6,553 @@
  * @brief matrix module, implementation of basic matrix operations.
  * This module is used mostly for linear equation system solving,
  * in order to find mine and clear cells.
+ * Compact matrix row kernels use AVX2 (when compiled with -mavx2, see ENABLE_AVX2) or SSE2 (x86 baseline),
+ * with a scalar fallback for other targets.
 **************************************************************************************************/
 #include <stdlib.h>
-#include <math.h>
 #include "matrix.h"
 #include "logger.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COMPACT_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COMPACT_SSE2
+#endif
+
+void reset_matrix(t_matrix matrix, double fill) {
+    for (int row = 0; row < matrix.size.rows; row++)
+        for (int col = 0; col < matrix.size.cols; col++) {
+            MATRIX_CELL(matrix, row, col) = fill;
+        }
+}
+
+t_matrix initialize_matrix(t_matrix_size matrix_size, double fill) {
+    t_matrix matrix = {NULL, matrix_size};
+    matrix.data = (t_data) malloc(sizeof(double) * matrix_size.rows * matrix_size.cols);
+    if (matrix.data == NULL)
+        goto lblReturn;
+    reset_matrix(matrix, fill);
+    lblReturn:
+    return matrix;
+}
+
+void reset_integer_matrix(t_integer_matrix matrix, int64_t fill) {
+    for (int row = 0; row < matrix.size.rows; row++)
+        for (int col = 0; col < matrix.size.cols; col++) {
+            INTEGER_MATRIX_CELL(matrix, row, col) = fill;
+        }
+}
+
 /**
- * @brief Swap two matrix rows inplace.
- * @param matrix - The matrix.
+ * @brief Swap two integer matrix rows inplace.
+ * @param matrix - The integer matrix.
  * @param row1 - First replaced row.
  * @param row2 - Second replaced row.
  * @return Void
  */
-void swap_rows(t_matrix matrix, int row1, int row2) {
+void swap_integer_rows(t_integer_matrix matrix, int row1, int row2) {
     for (int col = 0; col < matrix.size.cols; col++) {
-        double temp = MATRIX_CELL(matrix, row1, col);
-        MATRIX_CELL(matrix, row1, col) = MATRIX_CELL(matrix, row2, col);
-        MATRIX_CELL(matrix, row2, col) = temp;
+        int64_t temp = INTEGER_MATRIX_CELL(matrix, row1, col);
+        INTEGER_MATRIX_CELL(matrix, row1, col) = INTEGER_MATRIX_CELL(matrix, row2, col);
+        INTEGER_MATRIX_CELL(matrix, row2, col) = temp;
+    }
+}
+
+int64_t get_gcd(int64_t a, int64_t b) {
+    a = a < 0 ? -a : a;
+    b = b < 0 ? -b : b;
+    while (b) {
+        int64_t remainder = a % b;
+        a = b;
+        b = remainder;
     }
+    return a;
 }
 
 /**
- * @brief Multiply a matrix row in scalar (inplace).
- * @param matrix - The matrix.
- * @param row - Multiplied row index.
- * @param factor - Multiplication scalar factor.
+ * @brief Divide an integer matrix row by the gcd of its cells (inplace).
+ * @param matrix - The integer matrix.
+ * @param row - Normalized row index.
+ * @param first_col - First column that may be non-zero.
  * @return Void
  */
-void multiply_row(t_matrix matrix, int row, double factor) {
-    for (int col = 0; col < matrix.size.cols; col++) {
-        MATRIX_CELL(matrix, row, col) *= factor;
+void normalize_integer_row(t_integer_matrix matrix, int row, int first_col) {
+    int64_t gcd = 0;
+    for (int col = first_col; col < matrix.size.cols && gcd != 1; col++)
+        gcd = get_gcd(gcd, INTEGER_MATRIX_CELL(matrix, row, col));
+    if (gcd > 1)
+        for (int col = first_col; col < matrix.size.cols; col++)
+            INTEGER_MATRIX_CELL(matrix, row, col) /= gcd;
+}
+
+/**
+ * @brief Eliminate a pivot column from a row, by a fraction-free row operation (inplace):
+ * row = (pivot * row - row[pivot_col] * pivot_row) / divisor.
+ * @param matrix - The integer matrix.
+ * @param row - The changed row index.
+ * @param pivot_row - The pivot row index.
+ * @param pivot_col - The pivot column index.
+ * @param divisor - Exact divisor of the result (former pivot in Bareiss mode, 1 otherwise).
+ * @return Boolean, true on success, false if a cell exceeds INTEGER_ELIMINATION_LIMIT.
+ */
+bool eliminate_integer_row(t_integer_matrix matrix, int row, int pivot_row, int pivot_col, int64_t divisor) {
+    int64_t pivot = INTEGER_MATRIX_CELL(matrix, pivot_row, pivot_col);
+    int64_t factor = INTEGER_MATRIX_CELL(matrix, row, pivot_col);
+    for (int col = pivot_col + 1; col < matrix.size.cols; col++) {
+        int64_t value = (pivot * INTEGER_MATRIX_CELL(matrix, row, col) -
+                         factor * INTEGER_MATRIX_CELL(matrix, pivot_row, col)) / divisor;
+        if (value > INTEGER_ELIMINATION_LIMIT || value < -INTEGER_ELIMINATION_LIMIT)
+            return false;
+        INTEGER_MATRIX_CELL(matrix, row, col) = value;
     }
+    INTEGER_MATRIX_CELL(matrix, row, pivot_col) = 0;
+    return true;
 }
 
 /**
- * @brief Add a row to another (inplace).
- * @param matrix - The matrix.
- * @param base_row - The changed row index.
- * @param added_row - The row index that we wish to add to base row.
- * @return Void
+ * @brief Eliminate a pivot column from a row that may have non-zero cells before the pivot column (inplace):
+ * row = pivot * row - row[pivot_col] * pivot_row, where pivot row is zero before the pivot column.
+ * @param matrix - The integer matrix.
+ * @param row - The changed row index.
+ * @param pivot_row - The pivot row index.
+ * @param pivot_col - The pivot column index.
+ * @param first_col - First non-zero column of row.
+ * @return Boolean, true on success, false if a cell exceeds INTEGER_ELIMINATION_LIMIT.
  */
-void add_row(t_matrix matrix, int base_row, int added_row) {
-    for (int col = 0; col < matrix.size.cols; col++) {
-        MATRIX_CELL(matrix, base_row, col) += MATRIX_CELL(matrix, added_row, col);
+bool eliminate_leading_integer_row(t_integer_matrix matrix, int row, int pivot_row, int pivot_col, int first_col) {
+    int64_t pivot = INTEGER_MATRIX_CELL(matrix, pivot_row, pivot_col);
+    for (int col = first_col; col < pivot_col && pivot != 1; col++) {
+        int64_t value = pivot * INTEGER_MATRIX_CELL(matrix, row, col);
+        if (value > INTEGER_ELIMINATION_LIMIT || value < -INTEGER_ELIMINATION_LIMIT)
+            return false;
+        INTEGER_MATRIX_CELL(matrix, row, col) = value;
     }
+    return eliminate_integer_row(matrix, row, pivot_row, pivot_col, 1);
 }
 
-void gauss_eliminate(t_matrix matrix) {
+/**
+ * @brief Get the first non-zero variable column of an integer matrix row.
+ * @param matrix - The integer matrix.
+ * @param row - Row index.
+ * @param first_col - First column that may be non-zero.
+ * @return Column index, the bias column if all variables are zero.
+ */
+int get_integer_leading_col(t_integer_matrix matrix, int row, int first_col) {
+    int col = first_col;
+    while (col < matrix.size.cols - 1 && INTEGER_MATRIX_CELL(matrix, row, col) == 0)
+        col++;
+    return col;
+}
+
+/**
+ * @brief Move rows of an integer matrix to a given order (inplace, by swaps).
+ * @param matrix - The integer matrix.
+ * @param order - Original row index of every final row.
+ * @param positions - Scratch, rows number integers.
+ * @param rows - Scratch, rows number integers.
+ * @return Void.
+ */
+void permute_integer_rows(t_integer_matrix matrix, const int *order, int *positions, int *rows) {
+    for (int row = 0; row < matrix.size.rows; row++) {
+        positions[row] = row;
+        rows[row] = row;
+    }
+    for (int row = 0; row < matrix.size.rows; row++) {
+        int position = positions[order[row]];
+        if (position == row)
+            continue;
+        swap_integer_rows(matrix, row, position);
+        rows[position] = rows[row];
+        positions[rows[row]] = position;
+        rows[row] = order[row];
+        positions[order[row]] = row;
+    }
+}
+
+/**
+ * @brief Eliminate a tile of rows among themselves, once they are zero in all former pivot columns.
+ * The leading column of the tile is eliminated by its smallest pivot, whose row joins the echelon rows, until all
+ * tile rows are echelon rows or zero rows.
+ * @param matrix - The integer matrix.
+ * @param tile_start - First row of tile.
+ * @param tile_end - Row after last row of tile.
+ * @param leading_cols - First non-zero column of every row.
+ * @param echelon_rows - Echelon rows sorted by pivot column, the new ones are inserted.
+ * @param echelon_number - Pointer to number of echelon rows.
+ * @return Boolean, true on success, false if a cell exceeds INTEGER_ELIMINATION_LIMIT.
+ */
+bool eliminate_integer_tile(t_integer_matrix matrix, int tile_start, int tile_end, int *leading_cols,
+                            int *echelon_rows, int *echelon_number) {
+    int bias_col = matrix.size.cols - 1;
+    while (true) {
+        int pivot_row = -1, col = bias_col;
+        for (int row = tile_start; row < tile_end; row++) {
+            int leading_col = leading_cols[row];
+            if (leading_col < 0 || leading_col >= bias_col || leading_col > col)
+                continue;
+            if (leading_col < col ||
+                llabs(INTEGER_MATRIX_CELL(matrix, row, col)) < llabs(INTEGER_MATRIX_CELL(matrix, pivot_row, col))) {
+                pivot_row = row;
+                col = leading_col;
+            }
+        }
+        if (col == bias_col)
+            return true;
+        for (int row = tile_start; row < tile_end; row++) {
+            if (row == pivot_row || leading_cols[row] != col)
+                continue;
+            if (!eliminate_integer_row(matrix, row, pivot_row, col, 1))
+                return false;
+            normalize_integer_row(matrix, row, col + 1);
+            leading_cols[row] = get_integer_leading_col(matrix, row, col + 1);
+        }
+        int position = *echelon_number;
+        for (; position > 0 && -1 - leading_cols[echelon_rows[position - 1]] > col; position--)
+            echelon_rows[position] = echelon_rows[position - 1];
+        echelon_rows[position] = pivot_row;
+        (*echelon_number)++;
+        leading_cols[pivot_row] = -1 - col; // Echelon rows keep their pivot column, and are left out of the tile.
+    }
+}
+
+/**
+ * @brief Perform exact gcd normalized Gaussian elimination over an integer matrix, by row tiles.
+ * Every tile is first reduced by the echelon rows found so far (streamed once, in pivot column order, while the tile
+ * stays in cache), the leading column of every tile row is found in the same pass, and the tile is then eliminated
+ * among itself. Echelon rows are finally moved to the top of the matrix, in pivot column order.
+ * @param matrix - The integer matrix.
+ * @param scratch - Scratch, 4 * rows number integers.
+ * @return Boolean, true on success, false if a cell exceeds INTEGER_ELIMINATION_LIMIT.
+ */
+bool blocked_integer_gauss_eliminate(t_integer_matrix matrix, int *scratch) {
+    int rows_number = matrix.size.rows;
+    int *leading_cols = scratch, *echelon_rows = scratch + rows_number;
+    int echelon_number = 0;
+    int tile_rows = BLOCKED_ELIMINATION_TILE_BYTES / (int) (sizeof(int64_t) * matrix.size.cols);
+    if (tile_rows < 1)
+        tile_rows = 1;
+    for (int tile_start = 0; tile_start < rows_number; tile_start += tile_rows) {
+        int tile_end = tile_start + tile_rows < rows_number ? tile_start + tile_rows : rows_number;
+        for (int row = tile_start; row < tile_end; row++)
+            leading_cols[row] = get_integer_leading_col(matrix, row, 0);
+        for (int i = 0; i < echelon_number; i++) {
+            int echelon_row = echelon_rows[i], col = -1 - leading_cols[echelon_row];
+            for (int row = tile_start; row < tile_end; row++) {
+                if (leading_cols[row] > col || INTEGER_MATRIX_CELL(matrix, row, col) == 0)
+                    continue;
+                if (!eliminate_leading_integer_row(matrix, row, echelon_row, col, leading_cols[row]))
+                    return false;
+                normalize_integer_row(matrix, row, leading_cols[row]);
+                if (leading_cols[row] == col)
+                    leading_cols[row] = get_integer_leading_col(matrix, row, col + 1);
+            }
+        }
+        if (!eliminate_integer_tile(matrix, tile_start, tile_end, leading_cols, echelon_rows, &echelon_number))
+            return false;
+    }
+    for (int row = 0; row < rows_number; row++)
+        if (leading_cols[row] >= 0)
+            echelon_rows[echelon_number++] = row;
+    permute_integer_rows(matrix, echelon_rows, scratch + 2 * rows_number, scratch + 3 * rows_number);
+    return true;
+}
+
+bool integer_gauss_eliminate(t_integer_matrix matrix, t_elimination_mode elimination_mode) {
     int row = 0;
     int col = 0;
-    log_matrix(matrix, "Matrix before gaussian elimination");
-    while ((row < matrix.size.rows) && (col < matrix.size.cols)) {
-        int max_row = row;
-        for (int current_row = row + 1; current_row < matrix.size.rows; ++current_row) {
-            if (fabs(MATRIX_CELL(matrix, current_row, col)) > fabs(MATRIX_CELL(matrix, max_row, col))) {
-                max_row = current_row;
-            }
+    int64_t former_pivot = 1;
+    log_integer_matrix(matrix, "Matrix before integer elimination");
+    if (elimination_mode == ELIMINATION_GCD_NORMALIZED &&
+        (size_t) matrix.size.rows * matrix.size.cols > BLOCKED_ELIMINATION_MIN_CELLS) {
+        int *scratch = (int *) malloc(sizeof(int) * 4 * matrix.size.rows);
+        // Without scratch memory, the matrix is eliminated pivot by pivot.
+        if (scratch) {
+            bool is_eliminated = blocked_integer_gauss_eliminate(matrix, scratch);
+            free(scratch);
+            log_integer_matrix(matrix, "Matrix after blocked integer elimination");
+            return is_eliminated;
         }
-        if (MATRIX_CELL(matrix, max_row, col) != 0) {
-            if (row != max_row)
-                swap_rows(matrix, max_row, row);
-            double current_value = MATRIX_CELL(matrix, row, col);
-            multiply_row(matrix, row, 1 / current_value);
+    }
+    while ((row < matrix.size.rows) && (col < matrix.size.cols - 1)) {
+        int pivot_row = row;
+        for (int current_row = row; current_row < matrix.size.rows; ++current_row) {
+            int64_t value = INTEGER_MATRIX_CELL(matrix, current_row, col);
+            int64_t pivot_value = INTEGER_MATRIX_CELL(matrix, pivot_row, col);
+            if (value != 0 && (pivot_value == 0 || llabs(value) < llabs(pivot_value)))
+                pivot_row = current_row;
+        }
+        if (INTEGER_MATRIX_CELL(matrix, pivot_row, col) != 0) {
+            if (row != pivot_row)
+                swap_integer_rows(matrix, pivot_row, row);
             for (int iter_row = row + 1; iter_row < matrix.size.rows; ++iter_row) {
-                double multiply_value = -MATRIX_CELL(matrix, iter_row, col);
-                if (multiply_value != 0) {
-                    multiply_row(matrix, row, multiply_value);
-                    add_row(matrix, iter_row, row);
-                    multiply_row(matrix, row, 1 / multiply_value);
+                if (elimination_mode == ELIMINATION_BAREISS) {
+                    if (!eliminate_integer_row(matrix, iter_row, row, col, former_pivot))
+                        return false;
+                } else if (INTEGER_MATRIX_CELL(matrix, iter_row, col) != 0) {
+                    if (!eliminate_integer_row(matrix, iter_row, row, col, 1))
+                        return false;
+                    normalize_integer_row(matrix, iter_row, col + 1);
                 }
             }
+            former_pivot = INTEGER_MATRIX_CELL(matrix, row, col);
             row++;
         }
         col++;
     }
-    log_matrix(matrix, "Matrix after gaussian elimination");
+    log_integer_matrix(matrix, "Matrix after integer elimination");
+    return true;
 }
 
-int get_last_non_zero_row(t_matrix matrix) {
-    for (int row = matrix.size.rows - 1; row >= 0 && row < matrix.size.rows; row--) {
-        bool is_non_zeros_row = false;
+int get_integer_last_non_zero_row(t_integer_matrix matrix) {
+    for (int row = matrix.size.rows - 1; row >= 0; row--) {
         for (int col = 0; col < matrix.size.cols; col++) {
-            if (MATRIX_CELL(matrix, row, col) != 0.0) {
-                is_non_zeros_row = true;
-            }
+            if (INTEGER_MATRIX_CELL(matrix, row, col) != 0)
+                return row;
         }
-        if (is_non_zeros_row)
-            return row;
     }
     return matrix.size.rows - 1;
 }
 
-t_matrix initialize_matrix(t_matrix_size matrix_size, double fill) {
-    t_matrix matrix = {NULL, matrix_size};
-    matrix.data = (t_data) malloc(sizeof(double) * matrix_size.rows * matrix_size.cols);
-    if (matrix.data == NULL)
-        goto lblReturn;
-    for (int row = 0; row < matrix_size.rows; row++)
-        for (int col = 0; col < matrix_size.cols; col++) {
-            MATRIX_CELL(matrix, row, col) = fill;
-        }
-    lblReturn:
-    return matrix;
-}
-
-double get_row_lower_bound(t_matrix matrix, int row) {
-    double lower_bound = 0;
+int64_t get_integer_row_lower_bound(t_integer_matrix matrix, int row) {
+    int64_t lower_bound = 0;
     for (int col = 0; col < matrix.size.cols - 1; col++) {
-        if (MATRIX_CELL(matrix, row, col) < 0)
-            lower_bound += MATRIX_CELL(matrix, row, col);
+        if (INTEGER_MATRIX_CELL(matrix, row, col) < 0)
+            lower_bound += INTEGER_MATRIX_CELL(matrix, row, col);
     }
     return lower_bound;
 }
 
-double get_row_upper_bound(t_matrix matrix, int row) {
-    double upper_bound = 0;
+int64_t get_integer_row_upper_bound(t_integer_matrix matrix, int row) {
+    int64_t upper_bound = 0;
     for (int col = 0; col < matrix.size.cols - 1; col++) {
-        if (MATRIX_CELL(matrix, row, col) > 0)
-            upper_bound += MATRIX_CELL(matrix, row, col);
+        if (INTEGER_MATRIX_CELL(matrix, row, col) > 0)
+            upper_bound += INTEGER_MATRIX_CELL(matrix, row, col);
     }
     return upper_bound;
 }
 
-double get_row_sum(t_matrix matrix, int row) {
-    double sum = 0;
-    for (int col = 0; col < matrix.size.cols - 1; col++)
-        sum += MATRIX_CELL(matrix, row, col);
-    return sum;
-}
\ No newline at end of file
+int get_compact_row_stride(int cols) {
+    return ((cols + COMPACT_ROW_LANES - 1) / COMPACT_ROW_LANES) * COMPACT_ROW_LANES;
+}
+
+/**
+ * @brief Cross-multiply a compact row against a pivot row (inplace): row = pivot * row - factor * pivot_row.
+ * @param row - The changed row.
+ * @param pivot_row - The pivot row.
+ * @param pivot - Pivot coefficient.
+ * @param factor - Changed row coefficient in pivot column.
+ * @param first_col - First column to change (aligned to COMPACT_ROW_LANES), former columns are zero in both rows.
+ * @param row_stride - Row stride.
+ * @return Maximal absolute value of changed row.
+ */
+int compact_row_axpy(int16_t *row, const int16_t *pivot_row, int16_t pivot, int16_t factor, int first_col,
+                     int row_stride) {
+    int max_value = 0;
+#if defined(COMPACT_AVX2)
+    __m256i pivots = _mm256_set1_epi16(pivot), factors = _mm256_set1_epi16(factor);
+    __m256i max_values = _mm256_setzero_si256();
+    for (int col = first_col; col < row_stride; col += 16) {
+        __m256i values = _mm256_load_si256((const __m256i *) (row + col));
+        __m256i pivot_values = _mm256_load_si256((const __m256i *) (pivot_row + col));
+        values = _mm256_sub_epi16(_mm256_mullo_epi16(values, pivots), _mm256_mullo_epi16(pivot_values, factors));
+        _mm256_store_si256((__m256i *) (row + col), values);
+        max_values = _mm256_max_epi16(max_values, _mm256_abs_epi16(values));
+    }
+    __m128i max_lanes = _mm_max_epi16(_mm256_castsi256_si128(max_values), _mm256_extracti128_si256(max_values, 1));
+    int16_t lanes[8];
+    _mm_storeu_si128((__m128i *) lanes, max_lanes);
+    for (int i = 0; i < 8; i++)
+        max_value = lanes[i] > max_value ? lanes[i] : max_value;
+#elif defined(COMPACT_SSE2)
+    __m128i pivots = _mm_set1_epi16(pivot), factors = _mm_set1_epi16(factor);
+    __m128i zeros = _mm_setzero_si128(), max_values = _mm_setzero_si128();
+    for (int col = first_col; col < row_stride; col += 8) {
+        __m128i values = _mm_load_si128((const __m128i *) (row + col));
+        __m128i pivot_values = _mm_load_si128((const __m128i *) (pivot_row + col));
+        values = _mm_sub_epi16(_mm_mullo_epi16(values, pivots), _mm_mullo_epi16(pivot_values, factors));
+        _mm_store_si128((__m128i *) (row + col), values);
+        max_values = _mm_max_epi16(max_values, _mm_max_epi16(values, _mm_sub_epi16(zeros, values)));
+    }
+    int16_t lanes[8];
+    _mm_storeu_si128((__m128i *) lanes, max_values);
+    for (int i = 0; i < 8; i++)
+        max_value = lanes[i] > max_value ? lanes[i] : max_value;
+#else
+    for (int col = first_col; col < row_stride; col++) {
+        int value = pivot * row[col] - factor * pivot_row[col];
+        row[col] = (int16_t) value;
+        value = value < 0 ? -value : value;
+        max_value = value > max_value ? value : max_value;
+    }
+#endif
+    return max_value;
+}
+
+/**
+ * @brief Swap two compact matrix rows and their biases inplace.
+ * @param matrix - The compact matrix.
+ * @param row1 - First replaced row.
+ * @param row2 - Second replaced row.
+ * @return Void
+ */
+void swap_compact_rows(t_compact_matrix matrix, int row1, int row2) {
+    int16_t *first_row = COMPACT_MATRIX_ROW(matrix, row1), *second_row = COMPACT_MATRIX_ROW(matrix, row2);
+#if defined(COMPACT_AVX2)
+    for (int col = 0; col < matrix.row_stride; col += 16) {
+        __m256i first_values = _mm256_load_si256((const __m256i *) (first_row + col));
+        __m256i second_values = _mm256_load_si256((const __m256i *) (second_row + col));
+        _mm256_store_si256((__m256i *) (first_row + col), second_values);
+        _mm256_store_si256((__m256i *) (second_row + col), first_values);
+    }
+#elif defined(COMPACT_SSE2)
+    for (int col = 0; col < matrix.row_stride; col += 8) {
+        __m128i first_values = _mm_load_si128((const __m128i *) (first_row + col));
+        __m128i second_values = _mm_load_si128((const __m128i *) (second_row + col));
+        _mm_store_si128((__m128i *) (first_row + col), second_values);
+        _mm_store_si128((__m128i *) (second_row + col), first_values);
+    }
+#else
+    for (int col = 0; col < matrix.row_stride; col++) {
+        int16_t temp = first_row[col];
+        first_row[col] = second_row[col];
+        second_row[col] = temp;
+    }
+#endif
+    int32_t temp_bias = matrix.biases[row1];
+    matrix.biases[row1] = matrix.biases[row2];
+    matrix.biases[row2] = temp_bias;
+}
+
+/**
+ * @brief Find the pivot of a column, the row (from first row) with the smallest non-zero absolute coefficient.
+ * Coefficients of a column are a stride apart, so the search is scalar, and stops on a unit coefficient.
+ * @param matrix - The compact matrix.
+ * @param first_row - First searched row.
+ * @param col - Column index.
+ * @return Pivot row index, -1 if column is zero from first row.
+ */
+int find_compact_pivot(t_compact_matrix matrix, int first_row, int col) {
+    int pivot_row = -1, pivot_value = 0;
+    for (int row = first_row; row < matrix.size.rows; row++) {
+        int value = abs(COMPACT_MATRIX_CELL(matrix, row, col));
+        if (value != 0 && (pivot_row == -1 || value < pivot_value)) {
+            pivot_row = row;
+            pivot_value = value;
+            if (value == 1)
+                break;
+        }
+    }
+    return pivot_row;
+}
+
+/**
+ * @brief Divide a compact row (and its bias) by the gcd of its cells (inplace).
+ * @param matrix - The compact matrix.
+ * @param row - Normalized row index.
+ * @param first_col - First column that may be non-zero.
+ * @return Maximal absolute value of normalized row (including bias).
+ */
+int normalize_compact_row(t_compact_matrix matrix, int row, int first_col) {
+    int16_t *row_data = COMPACT_MATRIX_ROW(matrix, row);
+    int64_t gcd = matrix.biases[row];
+    int max_value = 0;
+    for (int col = first_col; col < matrix.size.cols && gcd != 1; col++)
+        gcd = get_gcd(gcd, row_data[col]);
+    gcd = gcd > 1 ? gcd : 1;
+    for (int col = first_col; col < matrix.size.cols; col++) {
+        row_data[col] = (int16_t) (row_data[col] / gcd);
+        int value = abs(row_data[col]);
+        max_value = value > max_value ? value : max_value;
+    }
+    matrix.biases[row] = (int32_t) (matrix.biases[row] / gcd);
+    return abs(matrix.biases[row]) > max_value ? abs(matrix.biases[row]) : max_value;
+}
+
+bool compact_gauss_eliminate(t_compact_matrix matrix) {
+    int row = 0;
+    int col = 0;
+    while ((row < matrix.size.rows) && (col < matrix.size.cols)) {
+        int pivot_row = find_compact_pivot(matrix, row, col);
+        if (pivot_row != -1) {
+            if (row != pivot_row)
+                swap_compact_rows(matrix, pivot_row, row);
+            int16_t *pivot_data = COMPACT_MATRIX_ROW(matrix, row);
+            int16_t pivot = pivot_data[col];
+            int first_col = (col / COMPACT_ROW_LANES) * COMPACT_ROW_LANES;
+            for (int iter_row = row + 1; iter_row < matrix.size.rows; ++iter_row) {
+                int16_t *row_data = COMPACT_MATRIX_ROW(matrix, iter_row);
+                int16_t factor = row_data[col];
+                if (factor == 0)
+                    continue;
+                int max_value = compact_row_axpy(row_data, pivot_data, pivot, factor, first_col, matrix.row_stride);
+                int32_t bias = pivot * matrix.biases[iter_row] - factor * matrix.biases[row];
+                matrix.biases[iter_row] = bias;
+                if (abs(bias) > max_value)
+                    max_value = abs(bias);
+                if (max_value > 1)
+                    max_value = normalize_compact_row(matrix, iter_row, col + 1);
+                if (max_value > COMPACT_ELIMINATION_LIMIT)
+                    return false;
+            }
+            row++;
+        }
+        col++;
+    }
+    return true;
+}
+
+void expand_compact_matrix(t_compact_matrix compact_matrix, t_integer_matrix matrix) {
+    for (int row = 0; row < compact_matrix.size.rows; row++) {
+        int16_t *row_data = COMPACT_MATRIX_ROW(compact_matrix, row);
+        for (int col = 0; col < compact_matrix.size.cols; col++)
+            INTEGER_MATRIX_CELL(matrix, row, col) = row_data[col];
+        INTEGER_MATRIX_CELL(matrix, row, matrix.size.cols - 1) = compact_matrix.biases[row];
+    }
+}
+
+void get_compact_row_bounds(t_compact_matrix matrix, int row, int32_t *lower_bound, int32_t *upper_bound) {
+    int16_t *row_data = COMPACT_MATRIX_ROW(matrix, row);
+    int32_t lower = 0, upper = 0;
+#if defined(COMPACT_AVX2)
+    __m256i ones = _mm256_set1_epi16(1), zeros = _mm256_setzero_si256();
+    __m256i lower_sums = _mm256_setzero_si256(), upper_sums = _mm256_setzero_si256();
+    for (int col = 0; col < matrix.row_stride; col += 16) {
+        __m256i values = _mm256_load_si256((const __m256i *) (row_data + col));
+        lower_sums = _mm256_add_epi32(lower_sums, _mm256_madd_epi16(_mm256_min_epi16(values, zeros), ones));
+        upper_sums = _mm256_add_epi32(upper_sums, _mm256_madd_epi16(_mm256_max_epi16(values, zeros), ones));
+    }
+    int32_t lower_lanes[8], upper_lanes[8];
+    _mm256_storeu_si256((__m256i *) lower_lanes, lower_sums);
+    _mm256_storeu_si256((__m256i *) upper_lanes, upper_sums);
+    for (int i = 0; i < 8; i++) {
+        lower += lower_lanes[i];
+        upper += upper_lanes[i];
+    }
+#elif defined(COMPACT_SSE2)
+    __m128i ones = _mm_set1_epi16(1), zeros = _mm_setzero_si128();
+    __m128i lower_sums = _mm_setzero_si128(), upper_sums = _mm_setzero_si128();
+    for (int col = 0; col < matrix.row_stride; col += 8) {
+        __m128i values = _mm_load_si128((const __m128i *) (row_data + col));
+        lower_sums = _mm_add_epi32(lower_sums, _mm_madd_epi16(_mm_min_epi16(values, zeros), ones));
+        upper_sums = _mm_add_epi32(upper_sums, _mm_madd_epi16(_mm_max_epi16(values, zeros), ones));
+    }
+    int32_t lower_lanes[4], upper_lanes[4];
+    _mm_storeu_si128((__m128i *) lower_lanes, lower_sums);
+    _mm_storeu_si128((__m128i *) upper_lanes, upper_sums);
+    for (int i = 0; i < 4; i++) {
+        lower += lower_lanes[i];
+        upper += upper_lanes[i];
+    }
+#else
+    for (int col = 0; col < matrix.row_stride; col++) {
+        if (row_data[col] < 0)
+            lower += row_data[col];
+        else
+            upper += row_data[col];
+    }
+#endif
+    *lower_bound = lower;
+    *upper_bound = upper;
+}
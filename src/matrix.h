@@ -3,17 +3,53 @@
  * @project MinesweeperSolver
  * @author Yotam Sali
  * @date 25.5.2020
- * @brief Header of matrix module, exports basic double type matrix utilities.
+ * @brief Header of matrix module, exports basic double and integer type matrix utilities.
 **************************************************************************************************/
 #ifndef MINESWEEPERSOLVER_MATRIX_H
 #define MINESWEEPERSOLVER_MATRIX_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "board.h"
 
 /**
  * Macro for a cell (x_index, y_index) of matrix.
  */
-#define MATRIX_CELL(matrix, x_index, y_index) matrix.data[x_index * matrix.size.cols + y_index]
+#define MATRIX_CELL(matrix, x_index, y_index) (matrix).data[(x_index) * (matrix).size.cols + (y_index)]
+
+/**
+ * Macro for a cell (x_index, y_index) of integer matrix.
+ */
+#define INTEGER_MATRIX_CELL(matrix, x_index, y_index) MATRIX_CELL(matrix, x_index, y_index)
+
+/**
+ * Maximal absolute value of integer matrix cells during elimination,
+ * so every product of two cells (and their difference) fits in 64 bits.
+ */
+#define INTEGER_ELIMINATION_LIMIT INT32_MAX
+
+/**
+ * Integer matrices of more cells than this (beyond L2 cache) are eliminated by row tiles (gcd normalized mode).
+ * Every tile is sized to L1 cache, so the echelon rows are streamed once per tile instead of the whole matrix once per
+ * pivot.
+ */
+#define BLOCKED_ELIMINATION_MIN_CELLS (1 << 17)
+#define BLOCKED_ELIMINATION_TILE_BYTES (1 << 15)
+
+/**
+ * Macros for compact matrix rows.
+ * Compact rows are padded to COMPACT_ROW_LANES coefficients (one AVX2 register) and aligned to COMPACT_ROW_ALIGNMENT.
+ */
+#define COMPACT_ROW_LANES 16
+#define COMPACT_ROW_ALIGNMENT 32
+#define COMPACT_MATRIX_ROW(matrix, x_index) ((matrix).data + (size_t) (x_index) * (matrix).row_stride)
+#define COMPACT_MATRIX_CELL(matrix, x_index, y_index) COMPACT_MATRIX_ROW(matrix, x_index)[y_index]
+
+/**
+ * Maximal absolute value of compact matrix cells during elimination (int8 range),
+ * so cross-multiplied rows (pivot * row - factor * pivot_row) still fit in int16 lanes.
+ */
+#define COMPACT_ELIMINATION_LIMIT 127
 
 typedef t_board_size t_matrix_size;
 typedef t_board_cell t_matrix_cell;
@@ -22,6 +58,31 @@ typedef struct {
     t_data data;
     t_matrix_size size;
 } t_matrix;
+typedef int64_t *t_integer_data;
+typedef struct {
+    t_integer_data data;
+    t_matrix_size size;
+} t_integer_matrix;
+
+typedef int16_t *t_compact_data;
+/**
+ * Struct for compact equations matrix, coefficients are int16, and biases are kept aside
+ * (so row reductions run over whole padded rows).
+ */
+typedef struct {
+    t_compact_data data;    // Aligned rows of row_stride coefficients, padding coefficients are zero.
+    int32_t *biases;        // Bias of every row.
+    t_matrix_size size;     // Number of rows (equations) and columns (variables, without bias).
+    int row_stride;         // Number of coefficients in a padded row.
+} t_compact_matrix;
+
+/**
+ * Enum for integer elimination modes.
+ */
+typedef enum {
+    ELIMINATION_GCD_NORMALIZED,     // Cross-multiplication, every changed row is divided by its gcd.
+    ELIMINATION_BAREISS             // Bareiss fraction-free elimination, divides by the former pivot.
+} t_elimination_mode;
 
 /**
  * @brief Initialize double matrix pointer in heap.
@@ -32,42 +93,93 @@ typedef struct {
 t_matrix initialize_matrix(t_matrix_size matrix_size, double fill);
 
 /**
- * @brief Perform Gaussian elimination algorithm over a matrix.
- * For further details read https://en.wikipedia.org/wiki/Gaussian_elimination.
- * @param matrix Matrix to perform Gaussian elimination on.
+ * @brief Set all matrix cells to a value.
+ * @param matrix The matrix.
+ * @param fill - double value of all matrix cells.
+ * @return Void.
+ */
+void reset_matrix(t_matrix matrix, double fill);
+
+/**
+ * @brief Set all integer matrix cells to a value.
+ * @param matrix The integer matrix.
+ * @param fill - integer value of all matrix cells.
  * @return Void.
  */
-void gauss_eliminate(t_matrix matrix);
+void reset_integer_matrix(t_integer_matrix matrix, int64_t fill);
+
+/**
+ * @brief Get greatest common divisor of two integers.
+ * @param a - First integer.
+ * @param b - Second integer.
+ * @return Non-negative greatest common divisor (0 if both are 0).
+ */
+int64_t get_gcd(int64_t a, int64_t b);
+
+/**
+ * @brief Perform exact (fraction-free) Gaussian elimination over an integer matrix (last column is the bias).
+ * Rows are only cross-multiplied and divided exactly, so equalities over the result are exact.
+ * In gcd normalized mode, a matrix of more than BLOCKED_ELIMINATION_MIN_CELLS cells is eliminated by row tiles.
+ * @param matrix Integer matrix to perform elimination on.
+ * @param elimination_mode Elimination mode (gcd normalized rows or Bareiss).
+ * @return Boolean, true on success, false if a cell exceeds INTEGER_ELIMINATION_LIMIT (matrix is then undefined).
+ */
+bool integer_gauss_eliminate(t_integer_matrix matrix, t_elimination_mode elimination_mode);
 
 /**
- * @brief Get last row index of a matrix which is not a zeros row.
- * @param matrix - Searched matrix.
+ * @brief Get last row index of an integer matrix which is not a zeros row.
+ * @param matrix - Searched integer matrix.
  * @return Last row index (Integer) which is not a zeros row in the matrix.
  */
-int get_last_non_zero_row(t_matrix matrix);
+int get_integer_last_non_zero_row(t_integer_matrix matrix);
 
 /**
- * @brief Get upper bound for row equation with 1-0 variable range.
- * @param matrix - The matrix.
+ * @brief Get upper bound for integer row equation with 1-0 variable range.
+ * @param matrix - The integer matrix.
  * @param row - Row index.
  * @return Upper bound for row equation with 1-0 variable range.
  */
-double get_row_upper_bound(t_matrix matrix, int row);
+int64_t get_integer_row_upper_bound(t_integer_matrix matrix, int row);
 
 /**
- * @brief Get lower bound for row equation with 1-0 variable range.
- * @param matrix - The matrix.
+ * @brief Get lower bound for integer row equation with 1-0 variable range.
+ * @param matrix - The integer matrix.
  * @param row - Row index.
  * @return Lower bound for row equation with 1-0 variable range.
  */
-double get_row_lower_bound(t_matrix matrix, int row);
+int64_t get_integer_row_lower_bound(t_integer_matrix matrix, int row);
 
 /**
- * @brief Get matrix row sum.
- * @param matrix - The matrix.
+ * @brief Get number of coefficients of a padded compact row.
+ * @param cols Number of columns (variables).
+ * @return Padded row stride.
+ */
+int get_compact_row_stride(int cols);
+
+/**
+ * @brief Perform exact gcd normalized Gaussian elimination over a compact matrix, using SIMD row kernels
+ * (AVX2 when compiled with it, SSE2 on x86, scalar otherwise).
+ * @param matrix Compact matrix to perform elimination on.
+ * @return Boolean, true on success, false if a cell exceeds COMPACT_ELIMINATION_LIMIT (matrix is then undefined).
+ */
+bool compact_gauss_eliminate(t_compact_matrix matrix);
+
+/**
+ * @brief Copy a compact matrix into an integer matrix (bias as last column).
+ * @param compact_matrix The compact matrix.
+ * @param matrix Integer matrix of compact_matrix rows and columns + 1.
+ * @return Void.
+ */
+void expand_compact_matrix(t_compact_matrix compact_matrix, t_integer_matrix matrix);
+
+/**
+ * @brief Get lower and upper bounds for compact row equation with 1-0 variable range.
+ * @param matrix - The compact matrix.
  * @param row - Row index.
- * @return Row sum.
+ * @param lower_bound - Pointer to lower bound (sum of negative coefficients).
+ * @param upper_bound - Pointer to upper bound (sum of positive coefficients).
+ * @return Void.
  */
-double get_row_sum(t_matrix matrix, int row);
+void get_compact_row_bounds(t_compact_matrix matrix, int row, int32_t *lower_bound, int32_t *upper_bound);
 
 #endif //MINESWEEPERSOLVER_MATRIX_H
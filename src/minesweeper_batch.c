@@ -0,0 +1,91 @@
+/**************************************************************************************************
+ * @file minesweeper_batch.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief MinesweeperBatch main, plays a batch of seeded simulated games of a level over all cores.
+ * Results are printed as JSON (on stdout).
+**************************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+#include "minesweeper_solver_utils.h"
+#include "batch_runner.h"
+#include "timer.h"
+#include "error_codes.h"
+#include "common.h"
+
+/**
+ * Input arguments, all but level are optional.
+ */
+typedef enum {
+    ARG_EXE_NAME = 0,
+    ARG_GAME_LEVEL = 1, // Followed by rows, columns and mines for a custom level.
+} t_arg;
+
+/**
+ * Optional arguments, by their offset after the level arguments.
+ */
+typedef enum {
+    OPTIONAL_ARG_GAMES_NUMBER = 0,
+    OPTIONAL_ARG_THREADS_NUMBER = 1,
+    OPTIONAL_ARG_SEED = 2,
+    OPTIONAL_ARG_NUMBER // Number of optional arguments (not arg offset).
+} t_optional_arg;
+
+#define DEFAULT_GAMES_NUMBER 100000
+#define DEFAULT_SEED 1
+#define MAX_THREADS_NUMBER 1024
+#define NANOSECONDS_IN_SECOND 1000000000.0
+#define USAGE_MESSAGE "Usage: MinesweeperBatch level [games] [threads] [seed]\n"                    \
+                      " level - member of {beginner, intermediate, expert}, or custom rows cols mines\n" \
+                      " games - positive number of games (default 100000)\n"                          \
+                      " threads - number of threads, 0 (default) for number of cores\n"
+
+/**
+ * @brief MinesweeperBatch main.
+ */
+int main(int argc, char *argv[]) {
+    long games_number = DEFAULT_GAMES_NUMBER;
+    long threads_number = 0;
+    uint64_t seed = DEFAULT_SEED;
+    t_batch_statistics statistics;
+    t_level level;
+    int level_args_number;
+    ASSERT(argv != NULL);
+    t_error_code error_code = parse_level_args(argc, argv, ARG_GAME_LEVEL, &level, &level_args_number);
+    int first_optional_arg = ARG_GAME_LEVEL + level_args_number;
+    if (!error_code && argc > first_optional_arg + OPTIONAL_ARG_NUMBER)
+        error_code = ERROR_INCORRECT_USAGE_ARG_NUMBER;
+    else if (!error_code &&
+             ((argc > first_optional_arg + OPTIONAL_ARG_GAMES_NUMBER &&
+               !parse_integer_arg(argv[first_optional_arg + OPTIONAL_ARG_GAMES_NUMBER], 1, LONG_MAX, &games_number)) ||
+              (argc > first_optional_arg + OPTIONAL_ARG_THREADS_NUMBER &&
+               !parse_integer_arg(argv[first_optional_arg + OPTIONAL_ARG_THREADS_NUMBER], 0, MAX_THREADS_NUMBER,
+                                  &threads_number)) ||
+              (argc > first_optional_arg + OPTIONAL_ARG_SEED &&
+               !parse_unsigned_arg(argv[first_optional_arg + OPTIONAL_ARG_SEED], &seed))))
+        error_code = ERROR_INCORRECT_USAGE_ILLEGAL_ARG;
+    if (error_code) {
+        printf(USAGE_MESSAGE);
+        return error_code;
+    }
+    if (!threads_number)
+        threads_number = get_cores_number();
+    uint64_t start_time = get_time_nanoseconds();
+    error_code = run_batch(level.board_size, level.number_of_mines, games_number, (int) threads_number, seed,
+                           &statistics);
+    double seconds = (double) (get_time_nanoseconds() - start_time) / NANOSECONDS_IN_SECOND;
+    if (error_code)
+        return error_code;
+    double games = statistics.games ? (double) statistics.games : 1;
+    printf("{\"level\": \"%s\", \"rows\": %d, \"cols\": %d, \"mines\": %d, \"threads\": %d, \"seed\": %llu, "
+           "\"games\": %ld, \"wins\": %ld, \"errors\": %ld, \"win_rate\": %.4f, \"guesses_per_game\": %.3f, "
+           "\"turns_per_game\": %.3f, \"steals\": %ld, \"seconds\": %.3f, \"games_per_second\": %.1f}\n",
+           level.level_name, level.board_size.rows, level.board_size.cols, level.number_of_mines, (int) threads_number,
+           (unsigned long long) seed, statistics.games, statistics.wins, statistics.errors,
+           (double) statistics.wins / games, (double) statistics.guesses / games, (double) statistics.turns / games,
+           statistics.steals, seconds, seconds > 0 ? (double) statistics.games / seconds : 0);
+    return RETURN_CODE_SUCCESS;
+}
@@ -0,0 +1,313 @@
+/**************************************************************************************************
+ * @file minesweeper_bench.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief MinesweeperBench main, end-to-end solver benchmark over the simulator.
+ * Plays seeded games for every Minesweeper level, and for custom size and mines density sweeps,
+ * using the real get_moves loop (optionally within a time budget per turn). Reports win rate, guesses and turns per
+ * game, games per second and get_moves latency percentiles as JSON (on stdout).
+**************************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+#include "minesweeper_solver_utils.h"
+#include "board.h"
+#include "board_analyzer.h"
+#include "simulator.h"
+#include "timer.h"
+#include "error_codes.h"
+#include "common.h"
+#include "solver.h"
+
+/**
+ * Input arguments, all optional.
+ */
+typedef enum {
+    ARG_EXE_NAME = 0,
+    ARG_GAMES_NUMBER = 1,
+    ARG_SEED = 2,
+    ARG_BUDGET = 3,
+    ARG_SOLVER_THREADS = 4,
+    ARG_NUMBER // Number of argument (not arg index).
+} t_arg;
+
+#define DEFAULT_GAMES_NUMBER 1000
+#define DEFAULT_SEED 1
+#define DEFAULT_SOLVER_THREADS 1
+#define NANOSECONDS_IN_SECOND 1000000000.0
+#define INITIAL_LATENCIES_CAPACITY 4096
+#define NO_BUDGET 0
+#define MAX_SOLVER_THREADS 1024
+#define USAGE_MESSAGE "Usage: MinesweeperBench [games_per_configuration] [seed] [get_moves_budget_us] " \
+                      "[solver_threads]\n"                                                              \
+                      " games_per_configuration - positive number of games (default 1000)\n"          \
+                      " get_moves_budget_us - time budget of every turn, 0 (default) for no budget\n"  \
+                      " solver_threads - positive number of threads that solve a turn (default 1)\n"
+
+/**
+ * Custom board sizes sweep (with expert mines density).
+ */
+const t_board_size sizes_sweep[] = {{24, 24},
+                                    {40, 40},
+                                    {64, 32}};
+#define SIZE_SWEEP_DENSITY 0.20625
+
+/**
+ * Custom mines density sweep (over expert board size).
+ */
+const double densities_sweep[] = {0.10, 0.14, 0.18, 0.22};
+#define DENSITY_SWEEP_SIZE {30, 16}
+
+/**
+ * Struct for benchmark results of a single configuration.
+ */
+struct bench_result {
+    int games;
+    int wins;
+    int errors;
+    long guesses;
+    long quick_guesses; // Guesses made once the turn budget has passed.
+    long turns;
+    long cache_lookups; // Component cache lookups (and hits), over all games of configuration.
+    long cache_hits;
+    uint64_t total_nanoseconds;
+    uint64_t *latencies; // get_moves latencies in nanoseconds, one for every turn.
+    size_t latencies_number;
+    size_t latencies_capacity;
+};
+typedef struct bench_result t_bench_result;
+
+/**
+ * @brief Record a single get_moves latency.
+ * @param result Pointer to benchmark result.
+ * @param latency Latency in nanoseconds.
+ * @return Error code.
+ */
+t_error_code record_latency(t_bench_result *result, uint64_t latency) {
+    if (result->latencies_number == result->latencies_capacity) {
+        size_t capacity = result->latencies_capacity ? 2 * result->latencies_capacity : INITIAL_LATENCIES_CAPACITY;
+        uint64_t *latencies = (uint64_t *) realloc(result->latencies, capacity * sizeof(uint64_t));
+        if (!latencies)
+            return ERROR_BENCH_MEMORY_ALLOC;
+        result->latencies = latencies;
+        result->latencies_capacity = capacity;
+    }
+    result->latencies[result->latencies_number++] = latency;
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Play a single seeded game over the simulator.
+ * Turns are counted whether they change the board or not: a game that progresses reveals or flags a cell every turn,
+ * so a game that is not over after more turns than board cells is stalled, and is counted as error.
+ * @param solver Solver context.
+ * @param game Pointer to initialized game.
+ * @param level Level of game.
+ * @param budget_microseconds Time budget of every turn in microseconds, NO_BUDGET to use get_moves.
+ * @param result Pointer to benchmark result to update.
+ * @return Error code.
+ */
+t_error_code bench_game(t_solver *solver, t_game *game, t_level level, uint64_t budget_microseconds,
+                        t_bench_result *result) {
+    t_error_code error_code = RETURN_CODE_SUCCESS;
+    t_game_status game_status = GAME_ON;
+    int max_turns = level.board_size.rows * level.board_size.cols;
+    t_board board = initialize_board(level.board_size);
+    if (!board.cells)
+        return ERROR_INITIALIZE_BOARD_MEMORY;
+    t_moves moves;
+    error_code = get_first_moves(solver, &moves);
+    if (error_code)
+        goto lblCleanup;
+    for (int turn = 0; turn <= max_turns; turn++) {
+        error_code = simulate_moves(game, moves);
+        if (error_code)
+            goto lblCleanup;
+        update_board_from_game(game, board, &game_status);
+        if (game_status != GAME_ON)
+            goto lblCleanup;
+        uint64_t start_time = get_time_nanoseconds();
+        if (budget_microseconds == NO_BUDGET)
+            error_code = get_moves(solver, board, &moves);
+        else
+            error_code = get_moves_within_budget(solver, board, budget_microseconds, &moves);
+        uint64_t latency = get_time_nanoseconds() - start_time;
+        if (error_code)
+            goto lblCleanup;
+        result->turns++;
+        if (moves.is_guess)
+            result->guesses++;
+        if (moves.stage == MOVE_STAGE_QUICK_GUESS)
+            result->quick_guesses++;
+        error_code = record_latency(result, latency);
+        if (error_code)
+            goto lblCleanup;
+    }
+    error_code = ERROR_BENCH_GAME_STALLED;
+    lblCleanup:
+    free_board(board);
+    if (game_status == WIN)
+        result->wins++;
+    return error_code;
+}
+
+/**
+ * @brief Run all games of a single configuration.
+ * Game i is seeded with seed + i, so equal seeds replay equal games on every configuration.
+ * @param level Level of configuration.
+ * @param games_number Number of games.
+ * @param seed Base seed.
+ * @param budget_microseconds Time budget of every turn in microseconds, NO_BUDGET to use get_moves.
+ * @param solver_threads Number of threads that solve the components of a turn.
+ * @param result Pointer to benchmark result.
+ * @return Error code (only fatal errors, failed games are counted in result).
+ */
+t_error_code bench_configuration(t_level level, int games_number, uint64_t seed, uint64_t budget_microseconds,
+                                 int solver_threads, t_bench_result *result) {
+    t_game game;
+    t_solver solver;
+    t_error_code error_code = initialize_solver(&solver, level.board_size, level.number_of_mines, seed);
+    if (error_code)
+        return error_code;
+    error_code = set_solver_threads(&solver, solver_threads);
+    if (error_code) {
+        free_solver(&solver);
+        return error_code;
+    }
+    error_code = initialize_game(&game, level.board_size, level.number_of_mines, seed);
+    if (error_code) {
+        free_solver(&solver);
+        return error_code;
+    }
+    uint64_t start_time = get_time_nanoseconds();
+    for (int i = 0; i < games_number; i++) {
+        reset_game(&game, seed + i);
+        error_code = bench_game(&solver, &game, level, budget_microseconds, result);
+        result->games++;
+        if (error_code == ERROR_BENCH_MEMORY_ALLOC || error_code == ERROR_INITIALIZE_BOARD_MEMORY)
+            goto lblCleanup;
+        if (error_code)
+            result->errors++;
+        error_code = RETURN_CODE_SUCCESS;
+    }
+    lblCleanup:
+    result->total_nanoseconds = get_time_nanoseconds() - start_time;
+    result->cache_lookups = solver.component_cache.lookups;
+    result->cache_hits = solver.component_cache.hits;
+    free_game(&game);
+    free_solver(&solver);
+    return error_code;
+}
+
+/**
+ * Comparator of latencies, for qsort.
+ */
+int compare_latencies(const void *first, const void *second) {
+    uint64_t first_latency = *(const uint64_t *) first;
+    uint64_t second_latency = *(const uint64_t *) second;
+    return (first_latency > second_latency) - (first_latency < second_latency);
+}
+
+/**
+ * @brief Get latency percentile in microseconds (latencies must be sorted).
+ * @param result Pointer to benchmark result.
+ * @param percentile Percentile in range [0, 100].
+ * @return Latency percentile in microseconds.
+ */
+double get_latency_percentile(t_bench_result *result, double percentile) {
+    if (result->latencies_number == 0)
+        return 0;
+    size_t index = (size_t) (percentile / 100.0 * (double) (result->latencies_number - 1) + 0.5);
+    return (double) result->latencies[index] / NANOSECONDS_IN_MICROSECOND;
+}
+
+/**
+ * @brief Print a single configuration result as a JSON object.
+ * @param level Level of configuration.
+ * @param result Pointer to benchmark result.
+ * @param is_last Boolean, true if this is the last configuration (no trailing comma).
+ * @return Void.
+ */
+void print_result(t_level level, t_bench_result *result, bool is_last) {
+    double games = result->games ? (double) result->games : 1;
+    double seconds = (double) result->total_nanoseconds / NANOSECONDS_IN_SECOND;
+    qsort(result->latencies, result->latencies_number, sizeof(uint64_t), compare_latencies);
+    printf("    {\"name\": \"%s\", \"rows\": %d, \"cols\": %d, \"mines\": %d, \"games\": %d, \"wins\": %d, "
+           "\"errors\": %d, \"win_rate\": %.4f, \"guesses_per_game\": %.3f, \"quick_guesses_per_game\": %.3f, "
+           "\"turns_per_game\": %.3f, \"component_cache_hit_rate\": %.3f, "
+           "\"games_per_second\": %.1f, \"get_moves_latency_us\": {\"p50\": %.2f, \"p99\": %.2f}}%s\n",
+           level.level_name, level.board_size.rows, level.board_size.cols, level.number_of_mines,
+           result->games, result->wins, result->errors, (double) result->wins / games,
+           (double) result->guesses / games, (double) result->quick_guesses / games, (double) result->turns / games,
+           result->cache_lookups ? (double) result->cache_hits / (double) result->cache_lookups : 0,
+           seconds > 0 ? (double) result->games / seconds : 0,
+           get_latency_percentile(result, 50), get_latency_percentile(result, 99), is_last ? "" : ",");
+}
+
+/**
+ * @brief Benchmark a configuration and print its result.
+ * @param level Level of configuration.
+ * @param games_number Number of games.
+ * @param seed Base seed.
+ * @param budget_microseconds Time budget of every turn in microseconds, NO_BUDGET to use get_moves.
+ * @param solver_threads Number of threads that solve the components of a turn.
+ * @param is_last Boolean, true if this is the last configuration.
+ * @return Error code.
+ */
+t_error_code run_configuration(t_level level, int games_number, uint64_t seed, uint64_t budget_microseconds,
+                               int solver_threads, bool is_last) {
+    t_bench_result result = {0};
+    t_error_code error_code = bench_configuration(level, games_number, seed, budget_microseconds, solver_threads,
+                                                  &result);
+    if (!error_code)
+        print_result(level, &result, is_last);
+    free(result.latencies);
+    return error_code;
+}
+
+/**
+ * @brief MinesweeperBench main.
+ */
+int main(int argc, char *argv[]) {
+    t_error_code error_code = RETURN_CODE_SUCCESS;
+    long games_number = DEFAULT_GAMES_NUMBER;
+    uint64_t seed = DEFAULT_SEED;
+    uint64_t budget_microseconds = NO_BUDGET;
+    long solver_threads = DEFAULT_SOLVER_THREADS;
+    ASSERT(argv != NULL);
+    if (argc > ARG_NUMBER)
+        error_code = ERROR_INCORRECT_USAGE_ARG_NUMBER;
+    else if ((argc > ARG_GAMES_NUMBER && !parse_integer_arg(argv[ARG_GAMES_NUMBER], 1, INT_MAX, &games_number)) ||
+             (argc > ARG_SEED && !parse_unsigned_arg(argv[ARG_SEED], &seed)) ||
+             (argc > ARG_BUDGET && !parse_unsigned_arg(argv[ARG_BUDGET], &budget_microseconds)) ||
+             (argc > ARG_SOLVER_THREADS &&
+              !parse_integer_arg(argv[ARG_SOLVER_THREADS], 1, MAX_SOLVER_THREADS, &solver_threads)))
+        error_code = ERROR_INCORRECT_USAGE_ILLEGAL_ARG;
+    if (error_code) {
+        printf(USAGE_MESSAGE);
+        return error_code;
+    }
+    int sizes_number = sizeof(sizes_sweep) / sizeof(t_board_size);
+    int densities_number = sizeof(densities_sweep) / sizeof(double);
+    printf("{\n  \"games_per_configuration\": %ld,\n  \"seed\": %llu,\n  \"budget_us\": %llu,\n"
+           "  \"solver_threads\": %ld,\n  \"configurations\": [\n", games_number, (unsigned long long) seed,
+           (unsigned long long) budget_microseconds, solver_threads);
+    for (int i = 0; i < number_of_levels && !error_code; i++)
+        error_code = run_configuration(levels[i], games_number, seed, budget_microseconds, solver_threads,
+                                       false);
+    for (int i = 0; i < sizes_number && !error_code; i++) {
+        t_level level = {"size_sweep", sizes_sweep[i]};
+        level.number_of_mines = (int) (SIZE_SWEEP_DENSITY * level.board_size.rows * level.board_size.cols);
+        error_code = run_configuration(level, games_number, seed, budget_microseconds, solver_threads, false);
+    }
+    for (int i = 0; i < densities_number && !error_code; i++) {
+        t_level level = {"density_sweep", DENSITY_SWEEP_SIZE};
+        level.number_of_mines = (int) (densities_sweep[i] * level.board_size.rows * level.board_size.cols);
+        error_code = run_configuration(level, games_number, seed, budget_microseconds, solver_threads,
+                                       i == densities_number - 1);
+    }
+    printf("  ]\n}\n");
+    return error_code;
+}
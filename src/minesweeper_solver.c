@@ -7,6 +7,7 @@
 **************************************************************************************************/
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 #include "minesweeper_solver_utils.h"
 #include "logger.h"
 #include "commander.h"
@@ -14,46 +15,48 @@
 #include "board_analyzer.h"
 #include "error_codes.h"
 #include "common.h"
+#include "solver.h"
 
 /**
  * Input arguments, be careful when changing.
  */
 typedef enum {
     ARG_EXE_NAME = 0,
-    ARG_GAME_LEVEL = 1,
-    ARG_NUMBER // Number of argument (not arg index).
+    ARG_GAME_LEVEL = 1, // Followed by rows, columns and mines for a custom level.
 } t_arg;
 
-/**
- * Global variable of board_size, used for accessing board.
- */
-t_board_size board_size = {0, 0};
-
+#ifdef HEADLESS
+#define USAGE_MESSAGE "Usage: MinesweeperSolver.exe level \n level - member of {beginner, intermediate, expert}, " \
+                      "or custom rows cols mines\n"
+#else
 #define USAGE_MESSAGE "Usage: MinesweeperSolver.exe level \n level - member of {beginner, intermediate, expert}\n"
+#endif
 
 /**
  * @brief Play a single game trial.
+ * @param solver Solver context.
  * @param game_status Pointer for returning game result at the end.
  * @param minesweeper_level Wanted level of game.
  * @return Error code of game trial.
  */
-t_error_code play_game(t_game_status *game_status, t_level minesweeper_level) {
+t_error_code play_game(t_solver *solver, t_game_status *game_status, t_level minesweeper_level) {
     t_error_code error_code = RETURN_CODE_SUCCESS;
-    t_board board = initialize_board(board);
-    if (!board)
+    t_board board = initialize_board(minesweeper_level.board_size);
+    if (!board.cells)
         return ERROR_INITIALIZE_BOARD_MEMORY;
-    t_moves moves = get_first_moves();
+    t_moves moves;
+    error_code = get_first_moves(solver, &moves);
     while (!error_code) {
         error_code = execute_moves(moves);
         if (error_code)
             goto lblCleanup;
-        error_code = update_board(board, game_status, minesweeper_level.game_status_rect);
+        error_code = update_board(solver, board, game_status, minesweeper_level.game_status_rect);
         if (*game_status != GAME_ON || error_code)
             goto lblCleanup;
-        error_code = get_moves(board, &moves, minesweeper_level.number_of_mines);
+        error_code = get_moves(solver, board, &moves);
     }
     lblCleanup:
-    free(board);
+    free_board(board);
     return error_code;
 }
 
@@ -64,24 +67,30 @@ t_error_code play_game(t_game_status *game_status, t_level minesweeper_level) {
  */
 t_error_code start_game_trials(t_level minesweeper_level) {
     t_game_status game_status = GAME_ON;
-    board_size = minesweeper_level.board_size;
-    t_error_code error_code = raise_minesweeper();
+    t_solver solver;
+    t_error_code error_code = initialize_solver(&solver, minesweeper_level.board_size,
+                                                minesweeper_level.number_of_mines, (uint64_t) time(NULL));
     if (error_code)
         return error_code;
+    error_code = raise_minesweeper();
+    if (error_code)
+        goto lblCleanup;
     error_code = set_minesweeper_level(minesweeper_level);
     if (error_code)
-        return error_code;
+        goto lblCleanup;
     lblStartPlay:
-    error_code = play_game(&game_status, minesweeper_level);
+    error_code = play_game(&solver, &game_status, minesweeper_level);
     if (game_status == LOST && !error_code) {
         error_code = restart_game(minesweeper_level);
         if (error_code)
-            return error_code;
+            goto lblCleanup;
         error_code = log_game_restart();
         if (error_code)
-            return error_code;
+            goto lblCleanup;
         goto lblStartPlay;
     }
+    lblCleanup:
+    free_solver(&solver);
     return error_code;
 }
 
@@ -90,20 +99,27 @@ t_error_code start_game_trials(t_level minesweeper_level) {
  */
 int main(int argc, char *argv[]) {
     t_error_code error_code = RETURN_CODE_SUCCESS;
+    t_level minesweeper_level;
+    int level_args_number;
     ASSERT(argv != NULL);
-    if (argc != ARG_NUMBER) {
+    error_code = parse_level_args(argc, argv, ARG_GAME_LEVEL, &minesweeper_level, &level_args_number);
+    if (error_code)
+        goto lblUsageError;
+    if (argc != ARG_GAME_LEVEL + level_args_number) {
         error_code = ERROR_INCORRECT_USAGE_ARG_NUMBER;
         goto lblUsageError;
     }
-    const t_level *minesweeper_level_ptr = get_level(argv[ARG_GAME_LEVEL]);
-    if (minesweeper_level_ptr == NULL) {
+#ifndef HEADLESS
+    // Minesweeper X has no custom board, a custom level is played by simulated games only.
+    if (level_args_number == CUSTOM_LEVEL_ARGS_NUMBER) {
         error_code = ERROR_INCORRECT_USAGE_ILLEGAL_LEVEL;
         goto lblUsageError;
     }
+#endif
     error_code = open_log();
     if (error_code)
         goto lblReturn;
-    error_code = start_game_trials(*minesweeper_level_ptr);
+    error_code = start_game_trials(minesweeper_level);
     if (error_code)
         goto lblReturn;
     error_code = close_log();
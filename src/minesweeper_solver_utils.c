@@ -4,12 +4,15 @@
  * @author Yotam Sali
  * @date 25.5.2020
  * @brief MinesweeperSolver utilities file.
- * Includes Minesweeper levels specifications, board initializer, and opening move getter.
+ * Includes Minesweeper levels specifications (and custom levels), board initializer, and opening move getter.
 **************************************************************************************************/
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
 #include "board.h"
+#include "bitboard.h"
 #include "board_analyzer.h"
 #include "minesweeper_solver_utils.h"
 
@@ -25,44 +28,131 @@ const t_level levels[] = {{"expert",       {30, 16}, 5, 82,
                           {"beginner",     {8,  8},  5, 38,
                                   10, {66,  28},
                                   {68,  90,  63, 83}}};
+const int number_of_levels = sizeof(levels) / sizeof(t_level);
 
 /**
- * @brief Set all board cells to state unknown.
- * @param board Board pointer.
+ * @brief Set all board cells (and bitplanes) to state unknown.
+ * @param board The board.
  */
 void set_board_cells_to_unknown(t_board board) {
-    int board_cells_number = board_size.rows * board_size.cols;
-    for (int i = 0; i < board_cells_number; i++)
-        board[i] = UNKNOWN_CELL;
+    size_t board_cells_number = (size_t) board.size.rows * board.size.cols;
+    for (size_t i = 0; i < board_cells_number; i++)
+        board.cells[i] = UNKNOWN_CELL;
+    reset_board_planes(board);
 }
 
-t_board initialize_board() {
-    int board_memory_size = board_size.rows * board_size.cols * sizeof(t_cell_type);
-    t_board ptr_board = (t_board) malloc(board_memory_size);
-    if (!ptr_board) {
-        goto lblReturnPtr;
+t_board initialize_board(t_board_size board_size) {
+    size_t board_memory_size = sizeof(t_cell_type) * board_size.rows * board_size.cols;
+    int words_per_row = get_words_per_row(board_size.cols);
+    size_t planes_memory_size = sizeof(uint64_t) * board_size.rows * words_per_row * BOARD_PLANES_NUMBER;
+    t_board board = {NULL, board_size, words_per_row, NULL, NULL};
+    board.cells = (t_cell_type *) malloc(board_memory_size);
+    board.planes = (uint64_t *) malloc(planes_memory_size);
+    board.changed_words = (uint64_t *) calloc(get_changed_words_length(board_size), sizeof(uint64_t));
+    if (!board.cells || !board.planes || !board.changed_words) {
+        free_board(board);
+        board.cells = NULL;
+        board.planes = NULL;
+        board.changed_words = NULL;
+        goto lblReturnBoard;
     }
-    set_board_cells_to_unknown(ptr_board);
-    lblReturnPtr:
-    return ptr_board;
+    set_board_cells_to_unknown(board);
+    lblReturnBoard:
+    return board;
 }
 
-t_moves get_first_moves() {
-    t_move *first_move = (t_move *) malloc(sizeof(t_move));
-    t_board_cell first_move_cell = {board_size.rows / 2, board_size.cols / 2};
+void free_board(t_board board) {
+    free(board.cells);
+    free(board.planes);
+    free(board.changed_words);
+}
+
+t_error_code get_first_moves(t_solver *solver, t_moves *moves) {
+    reset_arena(&solver->turn_arena);
+    t_move *first_move = (t_move *) allocate_from_arena(&solver->turn_arena, sizeof(t_move));
+    if (!first_move)
+        return ERROR_ARENA_EXHAUSTED;
+    t_board_cell first_move_cell = {solver->board_size.rows / 2, solver->board_size.cols / 2};
     first_move->is_mine = false;
     first_move->cell = first_move_cell;
-    t_moves moves = {first_move, 1};
-    return moves;
+    moves->moves = first_move;
+    moves->number_of_moves = 1;
+    moves->is_guess = false;
+    moves->stage = MOVE_STAGE_NONE;
+    return RETURN_CODE_SUCCESS;
 }
 
 const t_level *get_level(char *level_arg) {
-    for (int i = 0; i < sizeof(levels) / sizeof(t_level); i++) {
+    for (int i = 0; i < number_of_levels; i++) {
         const t_level *level_ptr = &levels[i];
-        if (!strncmp(level_ptr->level_name, level_arg, sizeof(level_ptr->level_name))) {
+        if (!strcmp(level_ptr->level_name, level_arg)) {
             return level_ptr;
         }
     }
     return NULL;
 }
 
+
+bool parse_integer_arg(const char *arg, long min_value, long max_value, long *value) {
+    char *end;
+    errno = 0;
+    long parsed = strtol(arg, &end, 10);
+    if (errno || end == arg || *end != '\0' || parsed < min_value || parsed > max_value)
+        return false;
+    *value = parsed;
+    return true;
+}
+
+bool parse_unsigned_arg(const char *arg, uint64_t *value) {
+    char *end;
+    errno = 0;
+    // strtoull accepts (and negates) a minus sign, so digits are required first.
+    if (*arg < '0' || *arg > '9')
+        return false;
+    unsigned long long parsed = strtoull(arg, &end, 10);
+    if (errno || *end != '\0')
+        return false;
+    *value = (uint64_t) parsed;
+    return true;
+}
+
+/**
+ * @brief Parse a non-negative integer value of a custom level argument.
+ * @param value_arg The program input string parameter.
+ * @param value Pointer to value to set.
+ * @return Boolean, true if argument is a whole non-negative integer (within int range), false otherwise.
+ */
+bool parse_level_value(char *value_arg, int *value) {
+    long parsed;
+    if (!parse_integer_arg(value_arg, 0, INT_MAX, &parsed))
+        return false;
+    *value = (int) parsed;
+    return true;
+}
+
+t_error_code parse_level_args(int argc, char *argv[], int level_arg, t_level *level, int *level_args_number) {
+    t_level custom_level = {CUSTOM_LEVEL_NAME};
+    *level_args_number = 1;
+    if (level_arg >= argc)
+        return ERROR_INCORRECT_USAGE_ARG_NUMBER;
+    if (strcmp(argv[level_arg], CUSTOM_LEVEL_NAME) != 0) {
+        const t_level *level_ptr = get_level(argv[level_arg]);
+        if (!level_ptr)
+            return ERROR_INCORRECT_USAGE_ILLEGAL_LEVEL;
+        *level = *level_ptr;
+        return RETURN_CODE_SUCCESS;
+    }
+    *level_args_number = CUSTOM_LEVEL_ARGS_NUMBER;
+    if (level_arg + CUSTOM_LEVEL_ARGS_NUMBER > argc)
+        return ERROR_INCORRECT_USAGE_ARG_NUMBER;
+    if (!parse_level_value(argv[level_arg + 1], &custom_level.board_size.rows) ||
+        !parse_level_value(argv[level_arg + 2], &custom_level.board_size.cols) ||
+        !parse_level_value(argv[level_arg + 3], &custom_level.number_of_mines))
+        return ERROR_INCORRECT_USAGE_ILLEGAL_LEVEL;
+    long long cells_number = (long long) custom_level.board_size.rows * custom_level.board_size.cols;
+    // The first revealed cell is never a mine.
+    if (cells_number < 1 || cells_number > CUSTOM_LEVEL_MAX_CELLS || custom_level.number_of_mines >= cells_number)
+        return ERROR_INCORRECT_USAGE_ILLEGAL_LEVEL;
+    *level = custom_level;
+    return RETURN_CODE_SUCCESS;
+}
@@ -8,11 +8,25 @@
 #ifndef MINESWEEPERSOLVER_MINESWEEPER_SOLVER_UTILS_H
 #define MINESWEEPERSOLVER_MINESWEEPER_SOLVER_UTILS_H
 
-#include <windows.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include "error_codes.h"
 #include "board_analyzer.h"
 #include "board.h"
 
+#define CUSTOM_LEVEL_NAME "custom"
+#define CUSTOM_LEVEL_ARGS_NUMBER 4      // Level name, rows, columns and mines.
+#define CUSTOM_LEVEL_MAX_CELLS (1 << 27)
+
+/**
+ * Struct for a point in Minesweeper window coordinates.
+ */
+struct window_point {
+    int x;
+    int y;
+};
+typedef struct window_point t_window_point;
+
 /**
  * Minesweeper level parameters struct
  */
@@ -22,29 +36,76 @@ struct t_level {
     int x_button; // X cursor coordinate of level button.
     int y_button; // Y cursor coordinate of level button.
     int number_of_mines;
-    POINT point_game_restart; // Cursor point of game restart button.
+    t_window_point point_game_restart; // Cursor point of game restart button.
     t_cell_rect game_status_rect; // Pixels indexes rectangle of smiley.
 
 };
 typedef struct t_level t_level;
 
 /**
- * @brief Initialize board integer pointer in heap.
- * @return t_board (integer pointer), representing board with unknown cells.
+ * Minesweeper levels table (expert, intermediate and beginner) and its length.
+ */
+extern const t_level levels[];
+extern const int number_of_levels;
+
+/**
+ * @brief Initialize board cells in heap.
+ * @param board_size Board size.
+ * @return t_board representing board with unknown cells (NULL cells on memory allocation failure).
+ */
+t_board initialize_board(t_board_size board_size);
+
+/**
+ * @brief Free board cells, bitplanes and changed words bitmap.
+ * @param board The board.
+ * @return Void.
  */
-t_board initialize_board();
+void free_board(t_board board);
 
 /**
  * @brief Get first move in game, which is pressing the middle cell.
- * @return t_moves struct. Contains the single move.
+ * The move is served by the solver turn arena (like get_moves).
+ * @param solver Solver context of the game.
+ * @param moves Pointer to moves, set to the single move.
+ * @return Error code.
  */
-t_moves get_first_moves();
+t_error_code get_first_moves(t_solver *solver, t_moves *moves);
 
 /**
  * @brief Get level struct of requested level.
  * @param level_arg The program input string parameter of requested level.
- * @return Requested t_level struct of relevant level.
+ * @return Requested t_level struct of relevant level, NULL if there is no such level.
  */
 const t_level *get_level(char *level_arg);
 
+/**
+ * @brief Get the level of program arguments, a level name or a custom level ("custom rows cols mines").
+ * A custom level has no Minesweeper window parameters, so it is played by simulated games only.
+ * @param argc Number of program arguments.
+ * @param argv Program arguments.
+ * @param level_arg Index of level argument.
+ * @param level Pointer to level to set.
+ * @param level_args_number Pointer to number of arguments taken by level, to set.
+ * @return Error code, ERROR_INCORRECT_USAGE_ILLEGAL_LEVEL for an unknown level or illegal custom level values.
+ */
+t_error_code parse_level_args(int argc, char *argv[], int level_arg, t_level *level, int *level_args_number);
+
+/**
+ * @brief Parse a whole integer program argument within a range.
+ * @param arg The program input string parameter.
+ * @param min_value Minimal legal value.
+ * @param max_value Maximal legal value.
+ * @param value Pointer to value to set.
+ * @return Boolean, true if argument is a whole integer within range, false otherwise (value is not set).
+ */
+bool parse_integer_arg(const char *arg, long min_value, long max_value, long *value);
+
+/**
+ * @brief Parse a whole non-negative 64-bit program argument (such as a seed).
+ * @param arg The program input string parameter.
+ * @param value Pointer to value to set.
+ * @return Boolean, true if argument is a whole non-negative integer within range, false otherwise (value is not set).
+ */
+bool parse_unsigned_arg(const char *arg, uint64_t *value);
+
 #endif //MINESWEEPERSOLVER_MINESWEEPER_SOLVER_UTILS_H
\ No newline at end of file
@@ -0,0 +1,219 @@
+/**************************************************************************************************
+ * @file minesweeper_threads_check.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief MinesweeperThreadsCheck main, checks that moves don't depend on the number of solver threads.
+ * Plays the same seeded games with a single threaded solver and a multi threaded one in lockstep, over the simulator,
+ * and compares their moves every turn. Prints a JSON line for every configuration (on stdout), and returns
+ * ERROR_THREADS_CHECK_MOVES_MISMATCH once moves differ.
+**************************************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "minesweeper_solver_utils.h"
+#include "board.h"
+#include "board_analyzer.h"
+#include "simulator.h"
+#include "error_codes.h"
+#include "common.h"
+#include "solver.h"
+
+/**
+ * Input arguments, all optional.
+ */
+typedef enum {
+    ARG_EXE_NAME = 0,
+    ARG_GAMES_NUMBER = 1,
+    ARG_SOLVER_THREADS = 2,
+    ARG_SEED = 3,
+    ARG_NUMBER // Number of argument (not arg index).
+} t_arg;
+
+#define DEFAULT_GAMES_NUMBER 100
+#define DEFAULT_SOLVER_THREADS 4
+#define DEFAULT_SEED 1
+#define MAX_SOLVER_THREADS 1024
+#define LARGE_LEVEL_SIZE {64, 64}   // Frontiers of this size are solved over the thread pool.
+#define LARGE_LEVEL_MINES 700
+#define USAGE_MESSAGE "Usage: MinesweeperThreadsCheck [games_per_configuration] [solver_threads] [seed]\n" \
+                      " games_per_configuration - positive number of games (default 100)\n"             \
+                      " solver_threads - threads of the compared solver, at least 2 (default 4)\n"
+
+/**
+ * Struct for a played game of a single solver.
+ */
+struct checked_player {
+    t_solver solver;
+    t_game game;
+    t_board board;
+    t_moves moves;
+    t_game_status game_status;
+};
+typedef struct checked_player t_checked_player;
+
+/**
+ * @brief Initialize a player of a configuration.
+ * @param player Pointer to player.
+ * @param level Level of configuration.
+ * @param threads_number Number of solver threads.
+ * @param seed Seed of solver and game.
+ * @return Error code.
+ */
+t_error_code initialize_checked_player(t_checked_player *player, t_level level, int threads_number, uint64_t seed) {
+    player->board.cells = NULL;
+    t_error_code error_code = initialize_solver(&player->solver, level.board_size, level.number_of_mines, seed);
+    if (error_code)
+        return error_code;
+    error_code = set_solver_threads(&player->solver, threads_number);
+    if (!error_code)
+        error_code = initialize_game(&player->game, level.board_size, level.number_of_mines, seed);
+    if (error_code)
+        free_solver(&player->solver);
+    return error_code;
+}
+
+/**
+ * @brief Free a player of a configuration.
+ * @param player Pointer to player.
+ * @return Void.
+ */
+void free_checked_player(t_checked_player *player) {
+    free_game(&player->game);
+    free_solver(&player->solver);
+}
+
+/**
+ * @brief Play a player turn: apply its moves to its game, and get its next moves if the game goes on.
+ * @param player Pointer to player.
+ * @return Error code.
+ */
+t_error_code play_checked_turn(t_checked_player *player) {
+    t_error_code error_code = simulate_moves(&player->game, player->moves);
+    if (error_code)
+        return error_code;
+    update_board_from_game(&player->game, player->board, &player->game_status);
+    if (player->game_status != GAME_ON)
+        return RETURN_CODE_SUCCESS;
+    return get_moves(&player->solver, player->board, &player->moves);
+}
+
+/**
+ * @brief Check whether two turns have the same moves (cells, kinds, guess and stage).
+ * @param first First moves.
+ * @param second Second moves.
+ * @return Boolean, true if moves are the same.
+ */
+bool is_same_moves(t_moves first, t_moves second) {
+    if (first.number_of_moves != second.number_of_moves || first.is_guess != second.is_guess ||
+        first.stage != second.stage)
+        return false;
+    for (size_t i = 0; i < first.number_of_moves; i++)
+        if (first.moves[i].cell.row != second.moves[i].cell.row ||
+            first.moves[i].cell.col != second.moves[i].cell.col ||
+            first.moves[i].is_mine != second.moves[i].is_mine)
+            return false;
+    return true;
+}
+
+/**
+ * @brief Play a single seeded game by both players in lockstep, comparing their moves every turn.
+ * @param players Both players, with their games reset to the same seed.
+ * @param level Level of game.
+ * @param turns Pointer to number of turns, to update.
+ * @return Error code, ERROR_THREADS_CHECK_MOVES_MISMATCH once moves differ.
+ */
+t_error_code check_game(t_checked_player players[2], t_level level, long *turns) {
+    t_error_code error_code = RETURN_CODE_SUCCESS;
+    int max_turns = level.board_size.rows * level.board_size.cols;
+    for (int i = 0; i < 2; i++) {
+        players[i].game_status = GAME_ON;
+        players[i].board = initialize_board(level.board_size);
+        if (!players[i].board.cells)
+            error_code = ERROR_INITIALIZE_BOARD_MEMORY;
+        else if (!error_code)
+            error_code = get_first_moves(&players[i].solver, &players[i].moves);
+    }
+    for (int turn = 0; !error_code && turn <= max_turns; turn++) {
+        error_code = play_checked_turn(&players[0]);
+        if (!error_code)
+            error_code = play_checked_turn(&players[1]);
+        if (error_code)
+            break;
+        if (players[0].game_status != players[1].game_status)
+            error_code = ERROR_THREADS_CHECK_MOVES_MISMATCH;
+        else if (players[0].game_status != GAME_ON)
+            break;
+        else if (!is_same_moves(players[0].moves, players[1].moves))
+            error_code = ERROR_THREADS_CHECK_MOVES_MISMATCH;
+        (*turns)++;
+    }
+    for (int i = 0; i < 2; i++)
+        free_board(players[i].board);
+    return error_code;
+}
+
+/**
+ * @brief Check all games of a single configuration, and print its result.
+ * Game i is seeded with seed + i, and both solvers are seeded with seed.
+ * @param level Level of configuration.
+ * @param games_number Number of games.
+ * @param solver_threads Number of threads of the compared solver.
+ * @param seed Base seed.
+ * @return Error code.
+ */
+t_error_code check_configuration(t_level level, int games_number, int solver_threads, uint64_t seed) {
+    t_checked_player players[2];
+    long turns = 0;
+    int game_index = 0;
+    t_error_code error_code = initialize_checked_player(&players[0], level, 1, seed);
+    if (error_code)
+        return error_code;
+    error_code = initialize_checked_player(&players[1], level, solver_threads, seed);
+    if (error_code) {
+        free_checked_player(&players[0]);
+        return error_code;
+    }
+    for (; game_index < games_number && !error_code; game_index++) {
+        reset_game(&players[0].game, seed + game_index);
+        reset_game(&players[1].game, seed + game_index);
+        error_code = check_game(players, level, &turns);
+    }
+    printf("{\"name\": \"%s\", \"rows\": %d, \"cols\": %d, \"mines\": %d, \"games\": %d, \"turns\": %ld, "
+           "\"solver_threads\": %d, \"identical\": %s}\n", level.level_name, level.board_size.rows,
+           level.board_size.cols, level.number_of_mines, game_index, turns, solver_threads,
+           error_code == ERROR_THREADS_CHECK_MOVES_MISMATCH ? "false" : "true");
+    free_checked_player(&players[0]);
+    free_checked_player(&players[1]);
+    return error_code;
+}
+
+/**
+ * @brief MinesweeperThreadsCheck main.
+ */
+int main(int argc, char *argv[]) {
+    t_error_code error_code = RETURN_CODE_SUCCESS;
+    long games_number = DEFAULT_GAMES_NUMBER;
+    long solver_threads = DEFAULT_SOLVER_THREADS;
+    uint64_t seed = DEFAULT_SEED;
+    ASSERT(argv != NULL);
+    if (argc > ARG_NUMBER)
+        error_code = ERROR_INCORRECT_USAGE_ARG_NUMBER;
+    else if ((argc > ARG_GAMES_NUMBER && !parse_integer_arg(argv[ARG_GAMES_NUMBER], 1, INT32_MAX, &games_number)) ||
+             (argc > ARG_SOLVER_THREADS &&
+              !parse_integer_arg(argv[ARG_SOLVER_THREADS], 2, MAX_SOLVER_THREADS, &solver_threads)) ||
+             (argc > ARG_SEED && !parse_unsigned_arg(argv[ARG_SEED], &seed)))
+        error_code = ERROR_INCORRECT_USAGE_ILLEGAL_ARG;
+    if (error_code) {
+        printf(USAGE_MESSAGE);
+        return error_code;
+    }
+    for (int i = 0; i < number_of_levels && !error_code; i++)
+        error_code = check_configuration(levels[i], (int) games_number, (int) solver_threads, seed);
+    if (!error_code) {
+        t_level large_level = {"large", LARGE_LEVEL_SIZE};
+        large_level.number_of_mines = LARGE_LEVEL_MINES;
+        error_code = check_configuration(large_level, (int) games_number, (int) solver_threads, seed);
+    }
+    return error_code;
+}
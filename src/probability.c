@@ -0,0 +1,865 @@
+/**************************************************************************************************
+ * @file probability.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief probability module, computes the exact mine probability of every unknown cell.
+ * A cell probability is the fraction of all board configurations (consistent with the numeric cells
+ * and the total number of mines) in which the cell is a mine.
+ * Since components share no variable, the configurations of every component are enumerated on their own,
+ * and counted by their number of mines. A board configuration is then a choice of configuration for every component,
+ * together with one of the C(isolated cells, mines left) placements of the remaining mines in the isolated cells.
+ * The combination is done by convolving the components mines distributions (prefixes of former components, and
+ * a suffix of later components already weighted by the isolated cells binomials).
+ * Components too large to enumerate are sampled, and their estimated counts are combined the same way.
+**************************************************************************************************/
+#include <stdlib.h>
+#include <math.h>
+#include "bitboard.h"
+#include "timer.h"
+#include "probability.h"
+
+#define UNASSIGNED_VARIABLE -1
+
+/**
+ * @brief Initialize the search state of a worker.
+ * @param search Pointer to search state.
+ * @param cells_number Number of board cells.
+ * @return Boolean, true on success, false on memory allocation failure.
+ */
+bool initialize_probability_search(t_probability_search *search, int cells_number) {
+    search->values = (int *) malloc(sizeof(int) * cells_number);
+    search->equations_bias = (int *) malloc(sizeof(int) * cells_number);
+    search->equations_unassigned = (int *) malloc(sizeof(int) * cells_number);
+    search->variables_equations = (int *) malloc(sizeof(int) * cells_number * NEIGHBORS_NUMBER);
+    search->variables_equations_number = (int *) malloc(sizeof(int) * cells_number);
+    return search->values && search->equations_bias && search->equations_unassigned && search->variables_equations &&
+           search->variables_equations_number;
+}
+
+/**
+ * @brief Free the search state of a worker.
+ * @param search Pointer to search state.
+ * @return Void.
+ */
+void free_probability_search(t_probability_search *search) {
+    free(search->values);
+    free(search->equations_bias);
+    free(search->equations_unassigned);
+    free(search->variables_equations);
+    free(search->variables_equations_number);
+    search->values = NULL;
+    search->equations_bias = NULL;
+    search->equations_unassigned = NULL;
+    search->variables_equations = NULL;
+    search->variables_equations_number = NULL;
+}
+
+t_error_code initialize_probability_engine(t_probability_engine *engine, t_board_size board_size,
+                                           int workers_number) {
+    int cells_number = board_size.rows * board_size.cols;
+    bool is_searches_allocated = true;
+    engine->searches_number = workers_number > 1 ? workers_number : 1;
+    engine->searches = (t_probability_search *) calloc(engine->searches_number, sizeof(t_probability_search));
+    for (int i = 0; engine->searches && i < engine->searches_number; i++)
+        is_searches_allocated &= initialize_probability_search(&engine->searches[i], cells_number);
+    engine->distributions = (t_component_distribution *) malloc(sizeof(t_component_distribution) * cells_number);
+    engine->configurations = (double *) malloc(sizeof(double) * 2 * cells_number);
+    engine->global_weights = (double *) malloc(sizeof(double) * (cells_number + 1));
+    engine->suffix = (double *) malloc(sizeof(double) * (cells_number + 1));
+    engine->next_suffix = (double *) malloc(sizeof(double) * (cells_number + 1));
+    engine->weights = (double *) malloc(sizeof(double) * (cells_number + 1));
+    engine->variables_errors = (double *) calloc(cells_number, sizeof(double));
+    engine->variables_probabilities = (double *) malloc(sizeof(double) * cells_number);
+    engine->isolated_probability = 0;
+    engine->variables_mines = NULL;
+    engine->variables_mines_capacity = 0;
+    engine->prefixes = NULL;
+    engine->prefixes_capacity = 0;
+    engine->is_exact = false;
+    engine->deadline = NO_DEADLINE;
+    engine->component_cache = NULL;
+    engine->thread_pool = NULL;
+    if (!engine->searches || !is_searches_allocated || !engine->distributions || !engine->configurations ||
+        !engine->global_weights || !engine->suffix || !engine->next_suffix || !engine->weights ||
+        !engine->variables_errors || !engine->variables_probabilities) {
+        free_probability_engine(engine);
+        return ERROR_PROBABILITY_MEMORY_ALLOC;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_probability_engine(t_probability_engine *engine) {
+    for (int i = 0; engine->searches && i < engine->searches_number; i++)
+        free_probability_search(&engine->searches[i]);
+    free(engine->searches);
+    free(engine->distributions);
+    free(engine->configurations);
+    free(engine->global_weights);
+    free(engine->suffix);
+    free(engine->next_suffix);
+    free(engine->weights);
+    free(engine->variables_errors);
+    free(engine->variables_probabilities);
+    free(engine->variables_mines);
+    free(engine->prefixes);
+    engine->searches = NULL;
+    engine->searches_number = 0;
+    engine->distributions = NULL;
+    engine->configurations = NULL;
+    engine->global_weights = NULL;
+    engine->suffix = NULL;
+    engine->next_suffix = NULL;
+    engine->weights = NULL;
+    engine->variables_errors = NULL;
+    engine->variables_probabilities = NULL;
+    engine->variables_mines = NULL;
+    engine->variables_mines_capacity = 0;
+    engine->prefixes = NULL;
+    engine->prefixes_capacity = 0;
+}
+
+/**
+ * @brief Make sure a growable buffer can hold the required number of doubles.
+ * @param buffer Pointer to buffer.
+ * @param capacity Pointer to buffer capacity (number of doubles).
+ * @param required_capacity Required number of doubles.
+ * @return Boolean, true on success, false on memory allocation failure.
+ */
+bool reserve_probability_buffer(double **buffer, size_t *capacity, size_t required_capacity) {
+    if (*buffer && required_capacity <= *capacity)
+        return true;
+    size_t new_capacity = required_capacity ? required_capacity : 1;
+    double *data = (double *) realloc(*buffer, sizeof(double) * new_capacity);
+    if (!data)
+        return false;
+    *buffer = data;
+    *capacity = new_capacity;
+    return true;
+}
+
+/**
+ * @brief Assign (or unassign) a value of a variable, and update the state of its equations.
+ * @param search Pointer to search state.
+ * @param variable Component variable index.
+ * @param value Variable value (1 for a mine).
+ * @param direction 1 to assign, -1 to unassign.
+ * @return Boolean, true if all equations of variable can still be satisfied, false otherwise.
+ */
+bool apply_variable_value(t_probability_search *search, int variable, int value, int direction) {
+    bool is_consistent = true;
+    int *equations = search->variables_equations + variable * NEIGHBORS_NUMBER;
+    for (int k = 0; k < search->variables_equations_number[variable]; k++) {
+        int equation = equations[k];
+        search->equations_unassigned[equation] -= direction;
+        search->equations_bias[equation] -= direction * value;
+        if (search->equations_bias[equation] < 0 ||
+            search->equations_bias[equation] > search->equations_unassigned[equation])
+            is_consistent = false;
+    }
+    return is_consistent;
+}
+
+/**
+ * @brief Prepare the search state (equations and variables adjacency) of a component.
+ * @param search Pointer to search state.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @return Void.
+ */
+void prepare_component_search(t_probability_search *search, t_frontier *frontier, t_component component) {
+    for (int variable = 0; variable < component.variables_number; variable++) {
+        search->values[variable] = UNASSIGNED_VARIABLE;
+        search->variables_equations_number[variable] = 0;
+    }
+    for (int i = 0; i < component.equations_number; i++) {
+        t_equation *equation = &frontier->equations[component.first_equation + i];
+        search->equations_bias[i] = equation->bias;
+        search->equations_unassigned[i] = equation->variables_number;
+        for (int k = 0; k < equation->variables_number; k++) {
+            int variable = equation->variables[k] - component.first_variable;
+            search->variables_equations[variable * NEIGHBORS_NUMBER +
+                                        search->variables_equations_number[variable]++] = i;
+        }
+    }
+}
+
+/**
+ * @brief Enumerate all consistent configurations of a component, using backtracking.
+ * Variables are assigned in component order (which keeps equations local), and a branch is pruned once one
+ * of the equations can't be satisfied, or the number of mines exceeds the mines left.
+ * @param engine Pointer to engine.
+ * @param search Pointer to search state.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @param mines_left Number of mines that are not flagged.
+ * @param configurations Number of configurations by number of mines (variables_number + 1 counts).
+ * @param variables_mines Number of configurations a variable is a mine, by number of mines.
+ * @return Boolean, true if enumeration is done, false if search budget has exceeded.
+ */
+bool enumerate_component(const t_probability_engine *engine, t_probability_search *search, t_frontier *frontier,
+                         t_component component, int mines_left, double *configurations, double *variables_mines) {
+    int variables_number = component.variables_number;
+    int *values = search->values;
+    long search_nodes = 0;
+    int depth = 0, mines = 0;
+    prepare_component_search(search, frontier, component);
+    for (int k = 0; k <= variables_number; k++)
+        configurations[k] = 0;
+    for (size_t k = 0; k < (size_t) variables_number * (variables_number + 1); k++)
+        variables_mines[k] = 0;
+    while (depth >= 0) {
+        if (depth == variables_number) {
+            configurations[mines]++;
+            for (int variable = 0; variable < variables_number; variable++)
+                if (values[variable])
+                    variables_mines[(size_t) variable * (variables_number + 1) + mines]++;
+            depth--;
+            continue;
+        }
+        if (values[depth] != UNASSIGNED_VARIABLE) {
+            apply_variable_value(search, depth, values[depth], -1);
+            mines -= values[depth];
+        }
+        values[depth]++;
+        if (values[depth] > 1) {
+            values[depth] = UNASSIGNED_VARIABLE;
+            depth--;
+            continue;
+        }
+        if (++search_nodes > PROBABILITY_MAX_SEARCH_NODES ||
+            (search_nodes % PROBABILITY_TIME_CHECK_NODES == 0 && is_deadline_passed(engine->deadline)))
+            return false;
+        mines += values[depth];
+        if (apply_variable_value(search, depth, values[depth], 1) && mines <= mines_left)
+            depth++;
+    }
+    return true;
+}
+
+/**
+ * @brief Unassign the first variables of a component assignment, and restore the state of their equations.
+ * @param search Pointer to search state.
+ * @param assigned_number Number of assigned variables.
+ * @return Void.
+ */
+void clear_component_assignment(t_probability_search *search, int assigned_number) {
+    for (int variable = 0; variable < assigned_number; variable++) {
+        apply_variable_value(search, variable, search->values[variable], -1);
+        search->values[variable] = UNASSIGNED_VARIABLE;
+    }
+}
+
+/**
+ * @brief Draw a single assignment of a component, assigning its variables in order.
+ * A value is consistent if all equations of the variable can still be satisfied (and mines left are not exceeded),
+ * and it is chosen at random when both values are consistent. A sample may end with no consistent value (it is then
+ * dropped), since only the equations of every assigned variable are checked.
+ * @param search Pointer to search state, after component search is prepared (its generator is used).
+ * @param component The component.
+ * @param mines_left Number of mines that are not flagged.
+ * @param mines Pointer to number of mines of assignment, to set.
+ * @return Number of random choices (log2 of the sample weight), or -1 if the sample was dropped.
+ */
+int sample_component_assignment(t_probability_search *search, t_component component, int mines_left, int *mines) {
+    int random_choices = 0;
+    *mines = 0;
+    for (int variable = 0; variable < component.variables_number; variable++) {
+        bool is_clear_consistent = apply_variable_value(search, variable, 0, 1);
+        apply_variable_value(search, variable, 0, -1);
+        bool is_mine_consistent = false;
+        if (*mines < mines_left) {
+            is_mine_consistent = apply_variable_value(search, variable, 1, 1);
+            apply_variable_value(search, variable, 1, -1);
+        }
+        if (!is_clear_consistent && !is_mine_consistent) {
+            clear_component_assignment(search, variable);
+            return -1;
+        }
+        int value = is_mine_consistent;
+        if (is_clear_consistent && is_mine_consistent) {
+            value = get_random_index(&search->random_generator, 2);
+            random_choices++;
+        }
+        apply_variable_value(search, variable, value, 1);
+        search->values[variable] = value;
+        *mines += value;
+    }
+    return random_choices;
+}
+
+/**
+ * @brief Scale the estimated counts of a sampled component.
+ * @param configurations Number of configurations by number of mines.
+ * @param variables_mines Number of configurations a variable is a mine, by number of mines.
+ * @param variables_number Number of component variables.
+ * @param scale The scale.
+ * @return Void.
+ */
+void scale_component_counts(double *configurations, double *variables_mines, int variables_number, double scale) {
+    for (int k = 0; k <= variables_number; k++)
+        configurations[k] *= scale;
+    for (size_t k = 0; k < (size_t) variables_number * (variables_number + 1); k++)
+        variables_mines[k] *= scale;
+}
+
+/**
+ * @brief Estimate the configurations counts of a component, by sequential importance sampling.
+ * Weights are powers of 2, kept relative to a reference power (counts are rescaled when the reference grows),
+ * since only the ratios of a component counts matter.
+ * @param engine Pointer to engine.
+ * @param search Pointer to search state, with its generator seeded.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @param mines_left Number of mines that are not flagged.
+ * @param configurations Number of configurations by number of mines (variables_number + 1 counts), estimated.
+ * @param variables_mines Number of configurations a variable is a mine, by number of mines, estimated.
+ * @return Effective number of samples, 0 if all samples were dropped.
+ */
+double sample_component(const t_probability_engine *engine, t_probability_search *search, t_frontier *frontier,
+                        t_component component, int mines_left, double *configurations, double *variables_mines) {
+    int variables_number = component.variables_number;
+    int samples_number = PROBABILITY_SAMPLE_NODES / variables_number;
+    int reference_choices = -1, mines;
+    double weights_sum = 0, squared_weights_sum = 0;
+    if (samples_number < PROBABILITY_MIN_SAMPLES)
+        samples_number = PROBABILITY_MIN_SAMPLES;
+    prepare_component_search(search, frontier, component);
+    scale_component_counts(configurations, variables_mines, variables_number, 0);
+    for (int sample = 0; sample < samples_number; sample++) {
+        if (sample % PROBABILITY_TIME_CHECK_SAMPLES == PROBABILITY_TIME_CHECK_SAMPLES - 1 &&
+            is_deadline_passed(engine->deadline))
+            break;
+        int random_choices = sample_component_assignment(search, component, mines_left, &mines);
+        if (random_choices < 0)
+            continue;
+        if (random_choices > reference_choices) {
+            double scale = reference_choices < 0 ? 1 : ldexp(1, reference_choices - random_choices);
+            scale_component_counts(configurations, variables_mines, variables_number, scale);
+            weights_sum *= scale;
+            squared_weights_sum *= scale * scale;
+            reference_choices = random_choices;
+        }
+        double weight = ldexp(1, random_choices - reference_choices);
+        configurations[mines] += weight;
+        for (int variable = 0; variable < variables_number; variable++)
+            if (search->values[variable])
+                variables_mines[(size_t) variable * (variables_number + 1) + mines] += weight;
+        weights_sum += weight;
+        squared_weights_sum += weight * weight;
+        clear_component_assignment(search, variables_number);
+    }
+    return weights_sum > 0 ? weights_sum * weights_sum / squared_weights_sum : 0;
+}
+
+/**
+ * @brief Set the standard errors of a sampled component variables probabilities (without the global mine count).
+ * @param engine Pointer to engine.
+ * @param component The component.
+ * @param distribution Component distribution.
+ * @return Void.
+ */
+void set_sampled_errors(t_probability_engine *engine, t_component component, t_component_distribution distribution) {
+    double *configurations = engine->configurations + distribution.configurations_offset;
+    double total_configurations = 0;
+    for (int k = 0; k <= component.variables_number; k++)
+        total_configurations += configurations[k];
+    for (int variable = 0; variable < component.variables_number; variable++) {
+        double *variable_mines = engine->variables_mines + distribution.mines_offset +
+                                 (size_t) variable * (component.variables_number + 1);
+        double mine_configurations = 0;
+        for (int k = 0; k <= component.variables_number; k++)
+            mine_configurations += variable_mines[k];
+        double probability = mine_configurations / total_configurations;
+        engine->variables_errors[component.first_variable + variable] =
+                sqrt(probability * (1 - probability) / distribution.effective_samples);
+    }
+}
+
+/**
+ * @brief Estimate the mine probabilities of a component that couldn't be enumerated nor sampled.
+ * A variable probability is estimated by its densest equation (missing mines divided by unknowns),
+ * and the component is considered to have the rounded sum of these probabilities as its number of mines.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @param configurations Number of configurations by number of mines, set to the estimated number of mines.
+ * @param variables_probabilities Mine probability of every frontier variable, set for component variables.
+ * @return Void.
+ */
+void estimate_component(t_frontier *frontier, t_component component, double *configurations,
+                        double *variables_probabilities) {
+    double expected_mines = 0;
+    for (int variable = 0; variable < component.variables_number; variable++)
+        variables_probabilities[component.first_variable + variable] = 0;
+    for (int i = 0; i < component.equations_number; i++) {
+        t_equation *equation = &frontier->equations[component.first_equation + i];
+        double density = (double) equation->bias / equation->variables_number;
+        for (int k = 0; k < equation->variables_number; k++)
+            if (variables_probabilities[equation->variables[k]] < density)
+                variables_probabilities[equation->variables[k]] = density;
+    }
+    for (int variable = 0; variable < component.variables_number; variable++)
+        expected_mines += variables_probabilities[component.first_variable + variable];
+    for (int k = 0; k <= component.variables_number; k++)
+        configurations[k] = 0;
+    configurations[(int) (expected_mines + 0.5)] = 1;
+}
+
+/**
+ * @brief Set the weights of isolated cells, for every number of frontier mines.
+ * Weight of t frontier mines is C(isolated cells, mines left - t), computed in log-space and scaled by the
+ * maximal weight (only weights ratios matter).
+ * @param weights Weights to set.
+ * @param length Number of weights.
+ * @param isolated_cells Number of unknown cells with no numeric neighbor.
+ * @param mines_left Number of mines that are not flagged.
+ * @return Void.
+ */
+void set_global_weights(double *weights, int length, int isolated_cells, int mines_left) {
+    double max_log_weight = -INFINITY;
+    for (int t = 0; t < length; t++) {
+        int isolated_mines = mines_left - t;
+        if (isolated_mines < 0 || isolated_mines > isolated_cells) {
+            weights[t] = -INFINITY;
+            continue;
+        }
+        weights[t] = lgamma(isolated_cells + 1.0) - lgamma(isolated_mines + 1.0) -
+                     lgamma(isolated_cells - isolated_mines + 1.0);
+        if (weights[t] > max_log_weight)
+            max_log_weight = weights[t];
+    }
+    for (int t = 0; t < length; t++)
+        weights[t] = (weights[t] == -INFINITY) ? 0 : exp(weights[t] - max_log_weight);
+}
+
+/**
+ * @brief Scale a vector by its maximal value, to avoid overflow and underflow of products.
+ * @param vector The vector.
+ * @param length Vector length.
+ * @return Void.
+ */
+void normalize_vector(double *vector, int length) {
+    double max_value = 0;
+    for (int i = 0; i < length; i++)
+        if (vector[i] > max_value)
+            max_value = vector[i];
+    if (max_value > 0)
+        for (int i = 0; i < length; i++)
+            vector[i] /= max_value;
+}
+
+/**
+ * @brief Compute the mines distribution of all components prefixes.
+ * Prefix c is the (scaled) number of configurations of components 0..c-1, by their total number of mines.
+ * @param engine Pointer to engine.
+ * @param frontier Pointer to frontier.
+ * @param length Number of possible totals (number of mines of prefixes are truncated to length - 1).
+ * @return Void.
+ */
+void compute_prefixes(t_probability_engine *engine, t_frontier *frontier, int length) {
+    double *prefix = engine->prefixes;
+    for (int t = 0; t < length; t++)
+        prefix[t] = (t == 0);
+    for (int c = 0; c < frontier->components_number; c++) {
+        double *configurations = engine->configurations + engine->distributions[c].configurations_offset;
+        int variables_number = frontier->components[c].variables_number;
+        double *next_prefix = prefix + length;
+        for (int t = 0; t < length; t++) {
+            next_prefix[t] = 0;
+            for (int k = 0; k <= variables_number && k <= t; k++)
+                next_prefix[t] += configurations[k] * prefix[t - k];
+        }
+        normalize_vector(next_prefix, length);
+        prefix = next_prefix;
+    }
+}
+
+/**
+ * @brief Set the mine probabilities of an enumerated component variables.
+ * @param engine Pointer to engine.
+ * @param frontier Pointer to frontier.
+ * @param c Component index.
+ * @return Void.
+ */
+void set_component_probabilities(t_probability_engine *engine, t_frontier *frontier, int c) {
+    t_component component = frontier->components[c];
+    t_component_distribution distribution = engine->distributions[c];
+    double *configurations = engine->configurations + distribution.configurations_offset;
+    double *weights = engine->weights;
+    double total_weight = 0, total_configurations = 0;
+    for (int k = 0; k <= component.variables_number; k++) {
+        total_weight += configurations[k] * weights[k];
+        total_configurations += configurations[k];
+    }
+    for (int variable = 0; variable < component.variables_number; variable++) {
+        double *variable_mines = engine->variables_mines + distribution.mines_offset +
+                                 (size_t) variable * (component.variables_number + 1);
+        double mine_weight = 0, mine_configurations = 0;
+        bool is_mine = true;
+        for (int k = 0; k <= component.variables_number; k++) {
+            mine_weight += variable_mines[k] * weights[k];
+            mine_configurations += variable_mines[k];
+            // Counts are integral, so a mine in all weighted configurations is compared exactly.
+            if (configurations[k] * weights[k] > 0 && variable_mines[k] != configurations[k])
+                is_mine = false;
+        }
+        double probability = 0.5;
+        if (total_weight > 0)
+            probability = is_mine ? 1 : mine_weight / total_weight;
+        else if (total_configurations > 0)
+            probability = mine_configurations / total_configurations;
+        // A cell that no sample placed a mine in is not known to be safe, it gets the weight of a single sample.
+        if (distribution.is_sampled && probability < 1 / (distribution.effective_samples + 1))
+            probability = 1 / (distribution.effective_samples + 1);
+        engine->variables_probabilities[component.first_variable + variable] = probability;
+    }
+}
+
+/**
+ * @brief Get the lowest isolated cells mine probability that sampled components can tell apart from 0.
+ * Samples that all place the remaining mines on the frontier don't show isolated cells to be safe, so isolated cells
+ * get the weight of a single sample of the least sampled component, as sampled variables do.
+ * @param engine Pointer to engine, after components distributions are solved.
+ * @param frontier Pointer to frontier.
+ * @return Lowest isolated mine probability, 0 if no component is sampled.
+ */
+double get_sampled_isolated_floor(t_probability_engine *engine, t_frontier *frontier) {
+    double floor_probability = 0;
+    for (int c = 0; c < frontier->components_number; c++) {
+        t_component_distribution distribution = engine->distributions[c];
+        if (distribution.is_sampled && 1 / (distribution.effective_samples + 1) > floor_probability)
+            floor_probability = 1 / (distribution.effective_samples + 1);
+    }
+    return floor_probability;
+}
+
+/**
+ * @brief Get the exact mine probability of isolated cells, when the mine count forces them.
+ * @param engine Pointer to engine.
+ * @param totals Weights of frontier configurations, by number of frontier mines.
+ * @param length Number of possible totals of frontier mines.
+ * @param isolated_cells Number of unknown cells with no numeric neighbor.
+ * @param mines_left Number of mines that are not flagged.
+ * @return 0 if isolated cells are clear in all weighted configurations, 1 if they are all mines, -1 otherwise.
+ */
+int get_forced_isolated_probability(t_probability_engine *engine, const double *totals, int length,
+                                    int isolated_cells, int mines_left) {
+    bool is_clear = true, is_mine = true;
+    for (int t = 0; t < length; t++) {
+        if (totals[t] * engine->global_weights[t] <= 0)
+            continue;
+        if (mines_left - t != 0)
+            is_clear = false;
+        if (mines_left - t != isolated_cells)
+            is_mine = false;
+    }
+    return is_clear ? 0 : (is_mine ? 1 : -1);
+}
+
+/**
+ * @brief Combine all components under the global mine count, and set frontier probabilities.
+ * Components are visited from last to first, while the suffix holds for every number of former mines m,
+ * the (scaled) weight of all later components configurations together with the isolated cells placements.
+ * @param engine Pointer to engine.
+ * @param frontier Pointer to frontier.
+ * @param length Number of possible totals of frontier mines.
+ * @return Void.
+ */
+void combine_components(t_probability_engine *engine, t_frontier *frontier, int length) {
+    for (int t = 0; t < length; t++)
+        engine->suffix[t] = engine->global_weights[t];
+    for (int c = frontier->components_number - 1; c >= 0; c--) {
+        double *prefix = engine->prefixes + (size_t) c * length;
+        double *configurations = engine->configurations + engine->distributions[c].configurations_offset;
+        int variables_number = frontier->components[c].variables_number;
+        for (int k = 0; k <= variables_number; k++) {
+            engine->weights[k] = 0;
+            for (int t = 0; t + k < length; t++)
+                engine->weights[k] += prefix[t] * engine->suffix[t + k];
+        }
+        if (engine->distributions[c].is_solved || engine->distributions[c].is_sampled)
+            set_component_probabilities(engine, frontier, c);
+        for (int m = 0; m < length; m++) {
+            engine->next_suffix[m] = 0;
+            for (int k = 0; k <= variables_number && m + k < length; k++)
+                engine->next_suffix[m] += configurations[k] * engine->suffix[m + k];
+        }
+        normalize_vector(engine->next_suffix, length);
+        double *suffix = engine->suffix;
+        engine->suffix = engine->next_suffix;
+        engine->next_suffix = suffix;
+    }
+}
+
+/**
+ * @brief Get the expected number of mines of a component, when every configuration is weighted by density to the
+ * number of its mines.
+ * @param configurations Number of configurations by number of mines.
+ * @param variables_number Number of component variables.
+ * @param log_density Log of the mines density (odds of a mine).
+ * @return Expected number of component mines (0 if component has no configurations).
+ */
+double get_expected_component_mines(const double *configurations, int variables_number, double log_density) {
+    double max_log_weight = -INFINITY, total_weight = 0, mines_weight = 0;
+    for (int k = 0; k <= variables_number; k++)
+        if (configurations[k] > 0 && log(configurations[k]) + k * log_density > max_log_weight)
+            max_log_weight = log(configurations[k]) + k * log_density;
+    for (int k = 0; k <= variables_number && max_log_weight > -INFINITY; k++) {
+        if (configurations[k] <= 0)
+            continue;
+        double weight = exp(log(configurations[k]) + k * log_density - max_log_weight);
+        total_weight += weight;
+        mines_weight += k * weight;
+    }
+    return total_weight > 0 ? mines_weight / total_weight : 0;
+}
+
+/**
+ * @brief Combine all components by a fixed mines density, and set frontier and isolated cells probabilities.
+ * When there are many isolated cells, placing one more mine on the frontier changes the isolated placements by
+ * a nearly constant factor, so the global mine count acts as a density: a component configuration of k mines is
+ * weighted by density to the power of k, independently of other components. The density is found by bisection, so
+ * the expected number of frontier and isolated mines meets the mines left. It costs linear time in the frontier
+ * (rather than components times possible totals), and is used only when the exact combination is too large.
+ * @param engine Pointer to engine.
+ * @param frontier Pointer to frontier.
+ * @param isolated_cells Number of unknown cells with no numeric neighbor.
+ * @param mines_left Number of mines that are not flagged.
+ * @return Void.
+ */
+void combine_components_by_density(t_probability_engine *engine, t_frontier *frontier, int isolated_cells,
+                                   int mines_left) {
+    double low = -PROBABILITY_MAX_LOG_DENSITY, high = PROBABILITY_MAX_LOG_DENSITY;
+    for (int iteration = 0; iteration < PROBABILITY_DENSITY_ITERATIONS; iteration++) {
+        double log_density = (low + high) / 2;
+        double expected_mines = isolated_cells / (1 + exp(-log_density));
+        for (int c = 0; c < frontier->components_number; c++)
+            expected_mines += get_expected_component_mines(engine->configurations +
+                                                           engine->distributions[c].configurations_offset,
+                                                           frontier->components[c].variables_number, log_density);
+        if (expected_mines < mines_left)
+            low = log_density;
+        else
+            high = log_density;
+    }
+    double log_density = (low + high) / 2;
+    for (int c = 0; c < frontier->components_number; c++) {
+        int variables_number = frontier->components[c].variables_number;
+        double max_log_weight = log_density > 0 ? variables_number * log_density : 0;
+        if (!engine->distributions[c].is_solved && !engine->distributions[c].is_sampled)
+            continue;
+        for (int k = 0; k <= variables_number; k++)
+            engine->weights[k] = exp(k * log_density - max_log_weight);
+        set_component_probabilities(engine, frontier, c);
+    }
+    engine->isolated_probability = isolated_cells > 0 ? 1 / (1 + exp(-log_density)) : 0;
+    if (isolated_cells > 0 && engine->isolated_probability < get_sampled_isolated_floor(engine, frontier))
+        engine->isolated_probability = get_sampled_isolated_floor(engine, frontier);
+}
+
+/**
+ * @brief Clamp a mine probability to [0, 1].
+ * @param mine_probability Mine probability.
+ * @return Clamped probability.
+ */
+double clamp_probability(double mine_probability) {
+    if (mine_probability < 0)
+        return 0;
+    return mine_probability > 1 ? 1 : mine_probability;
+}
+
+/**
+ * Struct for the job of solving all components distributions, shared by the pool tasks.
+ */
+struct distributions_job {
+    t_probability_engine *engine;
+    t_frontier *frontier;
+    int mines_left;
+    uint64_t sampling_seed;     // Sampling generator of component c is seeded by sampling_seed + c.
+};
+typedef struct distributions_job t_distributions_job;
+
+/**
+ * @brief Enumerate a component, or copy its configurations counts from the component cache.
+ * Cached counts are enumerated with no mines limit, so the counts of more mines than are left are dropped (which is
+ * exactly what enumeration would prune). A component is cached only if its enumeration wasn't limited by mines left.
+ * @param engine Pointer to engine.
+ * @param search Pointer to search state.
+ * @param frontier Pointer to frontier.
+ * @param component The component.
+ * @param mines_left Number of mines that are not flagged.
+ * @param configurations Number of configurations by number of mines (variables_number + 1 counts).
+ * @param variables_mines Number of configurations a variable is a mine, by number of mines.
+ * @return Boolean, true if enumeration is done, false if search budget has exceeded.
+ */
+bool solve_component_distribution(const t_probability_engine *engine, t_probability_search *search,
+                                  t_frontier *frontier, t_component component, int mines_left,
+                                  double *configurations, double *variables_mines) {
+    t_component_cache *cache = engine->component_cache;
+    t_component_key *key = &search->component_key;
+    int variables_number = component.variables_number;
+    bool is_cacheable = cache && key_component(cache, key, frontier, component);
+    if (is_cacheable) {
+        lock_component_cache(cache);
+        t_component_entry *entry = find_component_entry(cache, key);
+        bool is_cached = entry && entry->is_distributed;
+        for (int mines = 0; is_cached && mines <= variables_number; mines++)
+            configurations[mines] = mines <= mines_left ? entry->configurations[mines] : 0;
+        for (int i = 0; is_cached && i < variables_number; i++) {
+            const uint32_t *entry_mines = entry->variables_mines + (size_t) i * (variables_number + 1);
+            double *mines_counts = variables_mines + (size_t) key->canonical_variables[i] * (variables_number + 1);
+            for (int mines = 0; mines <= variables_number; mines++)
+                mines_counts[mines] = mines <= mines_left ? entry_mines[mines] : 0;
+        }
+        unlock_component_cache(cache);
+        if (is_cached)
+            return true;
+    }
+    if (variables_number > PROBABILITY_MAX_ENUMERATED_VARIABLES ||
+        !enumerate_component(engine, search, frontier, component, mines_left, configurations, variables_mines))
+        return false;
+    if (!is_cacheable || mines_left < variables_number)
+        return true;
+    lock_component_cache(cache);
+    t_component_entry *entry = store_component_entry(cache, key);
+    for (int mines = 0; mines <= variables_number; mines++)
+        entry->configurations[mines] = (uint32_t) configurations[mines];
+    for (int i = 0; i < variables_number; i++) {
+        uint32_t *entry_mines = entry->variables_mines + (size_t) i * (variables_number + 1);
+        const double *mines_counts = variables_mines + (size_t) key->canonical_variables[i] * (variables_number + 1);
+        for (int mines = 0; mines <= variables_number; mines++)
+            entry_mines[mines] = (uint32_t) mines_counts[mines];
+    }
+    entry->is_distributed = true;
+    unlock_component_cache(cache);
+    return true;
+}
+
+/**
+ * @brief Solve the distribution of a single component (a pool task): enumerate it, or sample it, or estimate it.
+ * A task writes only its own distribution, counts, and its variables errors and probabilities.
+ * @param job_ptr Pointer to distributions job.
+ * @param c Component index.
+ * @param worker_index Index of running worker.
+ * @return Void.
+ */
+void solve_distribution_task(void *job_ptr, int c, int worker_index) {
+    t_distributions_job *job = (t_distributions_job *) job_ptr;
+    t_probability_engine *engine = job->engine;
+    t_probability_search *search = &engine->searches[worker_index];
+    t_component component = job->frontier->components[c];
+    t_component_distribution *distribution = &engine->distributions[c];
+    double *configurations = engine->configurations + distribution->configurations_offset;
+    double *variables_mines = engine->variables_mines + distribution->mines_offset;
+    bool is_timed_out = is_deadline_passed(engine->deadline);
+    distribution->is_solved = !is_timed_out && solve_component_distribution(engine, search, job->frontier, component,
+                                                                            job->mines_left, configurations,
+                                                                            variables_mines);
+    distribution->is_sampled = false;
+    for (int variable = 0; variable < component.variables_number; variable++)
+        engine->variables_errors[component.first_variable + variable] = 0;
+    if (!distribution->is_solved && !is_timed_out) {
+        seed_random_generator(&search->random_generator, job->sampling_seed + c);
+        distribution->effective_samples = sample_component(engine, search, job->frontier, component, job->mines_left,
+                                                           configurations, variables_mines);
+        distribution->is_sampled = distribution->effective_samples > 0;
+    }
+    if (distribution->is_sampled)
+        set_sampled_errors(engine, component, *distribution);
+    else if (!distribution->is_solved)
+        estimate_component(job->frontier, component, configurations, engine->variables_probabilities);
+}
+
+t_error_code compute_mine_probabilities(t_probability_engine *engine, t_frontier *frontier, int number_of_mines,
+                                        t_random_generator *random_generator) {
+    int mines_left = number_of_mines - frontier->flagged_mines;
+    if (mines_left < 0)
+        mines_left = 0;
+    int isolated_cells = frontier->unknown_cells - frontier->variables_number;
+    engine->isolated_probability = 0;
+
+    size_t variables_mines_size = 0;
+    for (int c = 0; c < frontier->components_number; c++) {
+        int variables_number = frontier->components[c].variables_number;
+        variables_mines_size += (size_t) variables_number * (variables_number + 1);
+    }
+    if (!reserve_probability_buffer(&engine->variables_mines, &engine->variables_mines_capacity,
+                                    variables_mines_size))
+        return ERROR_PROBABILITY_MEMORY_ALLOC;
+    int configurations_offset = 0;
+    size_t mines_offset = 0;
+    for (int c = 0; c < frontier->components_number; c++) {
+        engine->distributions[c].configurations_offset = configurations_offset;
+        engine->distributions[c].mines_offset = mines_offset;
+        configurations_offset += frontier->components[c].variables_number + 1;
+        mines_offset += (size_t) frontier->components[c].variables_number *
+                        (frontier->components[c].variables_number + 1);
+    }
+    uint64_t sampling_seed = ((uint64_t) get_random_number(random_generator) << 32) |
+                             get_random_number(random_generator);
+    t_distributions_job job = {engine, frontier, mines_left, sampling_seed};
+    bool is_parallel = engine->thread_pool && frontier->variables_number >= PROBABILITY_MIN_PARALLEL_VARIABLES;
+    if (engine->thread_pool)
+        run_pool_tasks(engine->thread_pool, frontier->components_number, is_parallel, solve_distribution_task, &job);
+    else
+        for (int c = 0; c < frontier->components_number; c++)
+            solve_distribution_task(&job, c, 0);
+    engine->is_exact = true;
+    for (int c = 0; c < frontier->components_number; c++)
+        engine->is_exact &= engine->distributions[c].is_solved;
+
+    int length = (frontier->variables_number < mines_left ? frontier->variables_number : mines_left) + 1;
+    if ((size_t) (frontier->components_number + 1) * length > PROBABILITY_MAX_COMBINED_TOTALS) {
+        engine->is_exact = false;
+        combine_components_by_density(engine, frontier, isolated_cells, mines_left);
+        return RETURN_CODE_SUCCESS;
+    }
+    if (!reserve_probability_buffer(&engine->prefixes, &engine->prefixes_capacity,
+                                    (size_t) (frontier->components_number + 1) * length))
+        return ERROR_PROBABILITY_MEMORY_ALLOC;
+    compute_prefixes(engine, frontier, length);
+    double *totals = engine->prefixes + (size_t) frontier->components_number * length;
+    set_global_weights(engine->global_weights, length, isolated_cells, mines_left);
+    double total_weight = 0, isolated_mines_weight = 0;
+    for (int t = 0; t < length; t++)
+        total_weight += totals[t] * engine->global_weights[t];
+    if (total_weight == 0) {
+        // Mine count can't be met (e.g. by estimated components), probabilities are computed without it.
+        engine->is_exact = false;
+        for (int t = 0; t < length; t++)
+            engine->global_weights[t] = 1;
+        for (int t = 0; t < length; t++)
+            total_weight += totals[t];
+    }
+    combine_components(engine, frontier, length);
+
+    if (isolated_cells <= 0)
+        return RETURN_CODE_SUCCESS;
+    for (int t = 0; t < length; t++)
+        isolated_mines_weight += totals[t] * engine->global_weights[t] * (mines_left - t);
+    double isolated_mine_probability = (total_weight > 0) ?
+                                       isolated_mines_weight / (total_weight * isolated_cells) : 0;
+    int forced_probability = get_forced_isolated_probability(engine, totals, length, isolated_cells, mines_left);
+    if (engine->is_exact && forced_probability >= 0)
+        isolated_mine_probability = forced_probability;
+    if (isolated_mine_probability < get_sampled_isolated_floor(engine, frontier))
+        isolated_mine_probability = get_sampled_isolated_floor(engine, frontier);
+    engine->isolated_probability = clamp_probability(isolated_mine_probability);
+    return RETURN_CODE_SUCCESS;
+}
+
+void estimate_mine_probabilities(t_probability_engine *engine, t_frontier *frontier, int number_of_mines) {
+    int isolated_cells = frontier->unknown_cells - frontier->variables_number;
+    double isolated_mines = number_of_mines - frontier->flagged_mines;
+    engine->is_exact = false;
+    engine->isolated_probability = 0;
+    for (int c = 0; c < frontier->components_number; c++)
+        estimate_component(frontier, frontier->components[c], engine->configurations,
+                           engine->variables_probabilities);
+    for (int variable = 0; variable < frontier->variables_number; variable++) {
+        isolated_mines -= engine->variables_probabilities[variable];
+        engine->variables_errors[variable] = 0;
+    }
+    if (isolated_cells > 0)
+        engine->isolated_probability = clamp_probability(isolated_mines / isolated_cells);
+}
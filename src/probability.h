@@ -0,0 +1,141 @@
+/**************************************************************************************************
+ * @file probability.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for probability module, exports exact mine probability of every unknown cell.
+ * Every frontier variable has its own probability, and all isolated cells (unknown cells with no numeric neighbor)
+ * share a single one, so no board-size map is kept.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_PROBABILITY_H
+#define MINESWEEPERSOLVER_PROBABILITY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "error_codes.h"
+#include "board.h"
+#include "frontier.h"
+#include "random_generator.h"
+#include "component_cache.h"
+#include "thread_pool.h"
+
+#define PROBABILITY_MAP_NULL -1.0
+#define PROBABILITY_MAX_SEARCH_NODES (1 << 20)  // Search budget of a single component enumeration.
+#define PROBABILITY_MAX_ENUMERATED_VARIABLES 64 // Larger components are sampled without trying to enumerate them.
+#define PROBABILITY_SAMPLE_NODES (1 << 16)      // Variables assignments budget of a single component sampling.
+#define PROBABILITY_MIN_SAMPLES 64              // Samples of a component, however large it is.
+#define PROBABILITY_TIME_CHECK_NODES 1024       // Enumeration nodes between two clock readings.
+#define PROBABILITY_TIME_CHECK_SAMPLES 16       // Samples between two clock readings.
+#define PROBABILITY_MIN_PARALLEL_VARIABLES 64   // Smaller frontiers are solved on the calling thread alone.
+#define PROBABILITY_MAX_COMBINED_TOTALS (1 << 22) // Larger combinations (components by mines totals) use a density.
+#define PROBABILITY_MAX_LOG_DENSITY 64.0        // Bisection range of the log of mines density.
+#define PROBABILITY_DENSITY_ITERATIONS 48       // Bisection steps of mines density.
+
+/**
+ * Struct for enumeration results of a single component.
+ */
+struct component_distribution {
+    int configurations_offset;  // Offset of configurations counts (indexed by number of mines) in engine buffer.
+    size_t mines_offset;        // Offset of variables mines counts (variable-major) in engine buffer.
+    bool is_solved;             // True if configurations are enumerated (exact counts).
+    bool is_sampled;            // True if configurations counts are estimated by sampling.
+    double effective_samples;   // Effective number of samples of a sampled component.
+};
+typedef struct component_distribution t_component_distribution;
+
+/**
+ * Struct for the search state of a single component, one for every worker thread.
+ */
+struct probability_search {
+    int *values;                                // Current assignment of component variables.
+    int *equations_bias;                        // Missing mines of every component equation.
+    int *equations_unassigned;                  // Unassigned variables of every component equation.
+    int *variables_equations;                   // NEIGHBORS_NUMBER equations indexes for every component variable.
+    int *variables_equations_number;
+    t_component_key component_key;              // Canonical form of searched component, for the component cache.
+    t_random_generator random_generator;        // Sampling generator, seeded for every component.
+};
+typedef struct probability_search t_probability_search;
+
+/**
+ * Struct for probability engine scratch buffers.
+ * Fixed buffers are allocated once in the size of board cells, others grow when needed and are reused.
+ */
+struct probability_engine {
+    t_probability_search *searches;             // Search state of every worker.
+    int searches_number;
+    t_component_distribution *distributions;    // Distribution of every component.
+    double *configurations;                     // Number of configurations of components, by number of mines.
+    double *global_weights;                     // Weight of isolated cells, by number of frontier mines.
+    double *suffix;                             // Weights of later components and isolated cells.
+    double *next_suffix;
+    double *weights;                            // Weights of a component, by number of component mines.
+    double *variables_mines;                    // Number of configurations a variable is a mine, by number of mines.
+    size_t variables_mines_capacity;
+    double *prefixes;                           // Mines distribution of all former components, for every component.
+    size_t prefixes_capacity;
+    double *variables_probabilities;            // Mine probability of every frontier variable.
+    double isolated_probability;                // Mine probability of every isolated cell.
+    double *variables_errors;                   // Standard error of every variable probability (0 if enumerated).
+    uint64_t deadline;                          // Enumeration and sampling stop at deadline (NO_DEADLINE by default).
+    t_component_cache *component_cache;         // Cache of components configurations counts, NULL if not cached.
+    t_thread_pool *thread_pool;                 // Pool that components are solved on, NULL to solve them in order.
+    bool is_exact;                              // True if all components are enumerated and the mine count is met.
+};
+typedef struct probability_engine t_probability_engine;
+
+/**
+ * @brief Initialize probability engine buffers.
+ * @param engine Pointer to engine.
+ * @param board_size Board size.
+ * @param workers_number Number of worker threads that may solve components at once (a search state for each).
+ * @return Error code.
+ */
+t_error_code initialize_probability_engine(t_probability_engine *engine, t_board_size board_size,
+                                           int workers_number);
+
+/**
+ * @brief Free probability engine buffers.
+ * @param engine Pointer to engine.
+ * @return Void.
+ */
+void free_probability_engine(t_probability_engine *engine);
+
+/**
+ * @brief Compute the exact mine probability of every unknown cell.
+ * Every component is enumerated by backtracking (pruned by its equations), giving the number of consistent
+ * configurations for every number of component mines. Components are then combined under the global mine count,
+ * where every total number of frontier mines is weighted by the number of ways to place the rest of the mines
+ * in the isolated cells (binomials in log-space).
+ * Components that are too large, or exceed the search budget, are sampled instead: sequential importance sampling
+ * assigns variables in order (a random value when both values are consistent), and weights every sample by 2 to the
+ * number of random choices, which makes the weighted counts unbiased estimates of the configurations counts.
+ * Sampled probabilities have standard errors (by the effective number of samples), and are never 0.
+ * When the combination is too large (PROBABILITY_MAX_COMBINED_TOTALS), the mine count is applied as a fixed mines
+ * density instead, and the probabilities are not exact.
+ * When the probabilities are exact, a cell that is a mine (or clear) in every configuration that meets the mine count
+ * is set to exactly 1 (or 0), so the global mine count takes part in deductions.
+ * Components are solved as independent tasks of the engine thread pool, and every sampled component has its own
+ * generator (seeded by a single draw of random_generator and the component index), so results don't depend on the
+ * number of threads (unless the engine deadline stops them).
+ * Probabilities are set to variables_probabilities and isolated_probability.
+ * @param engine Pointer to engine.
+ * @param frontier Pointer to frontier, after components split.
+ * @param number_of_mines Total number of mines in game.
+ * @param random_generator Pointer to random generator, for sampling.
+ * @return Error code.
+ */
+t_error_code compute_mine_probabilities(t_probability_engine *engine, t_frontier *frontier, int number_of_mines,
+                                        t_random_generator *random_generator);
+
+/**
+ * @brief Estimate the mine probability of every unknown cell, in linear time (when there is no time to compute them).
+ * A variable probability is estimated by its densest equation, and isolated cells share the mines that are left.
+ * @param engine Pointer to engine.
+ * @param frontier Pointer to frontier, after components split.
+ * @param number_of_mines Total number of mines in game.
+ * @return Void.
+ */
+void estimate_mine_probabilities(t_probability_engine *engine, t_frontier *frontier, int number_of_mines);
+
+#endif //MINESWEEPERSOLVER_PROBABILITY_H
@@ -0,0 +1,36 @@
+/**************************************************************************************************
+ * @file random_generator.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief random_generator module, implementation of xorshift64* pseudo random generator.
+ * The seed is scrambled using splitmix64, so close seeds (0, 1, 2...) produce unrelated sequences.
+**************************************************************************************************/
+#include "random_generator.h"
+
+#define SPLITMIX_INCREMENT 0x9E3779B97F4A7C15ULL
+#define SPLITMIX_MULTIPLIER1 0xBF58476D1CE4E5B9ULL
+#define SPLITMIX_MULTIPLIER2 0x94D049BB133111EBULL
+#define XORSHIFT_MULTIPLIER 0x2545F4914F6CDD1DULL
+
+void seed_random_generator(t_random_generator *generator, uint64_t seed) {
+    uint64_t state = seed + SPLITMIX_INCREMENT;
+    state = (state ^ (state >> 30)) * SPLITMIX_MULTIPLIER1;
+    state = (state ^ (state >> 27)) * SPLITMIX_MULTIPLIER2;
+    state = state ^ (state >> 31);
+    // Xorshift state must never be zero.
+    generator->state = state ? state : SPLITMIX_INCREMENT;
+}
+
+uint32_t get_random_number(t_random_generator *generator) {
+    uint64_t state = generator->state;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    generator->state = state;
+    return (uint32_t) ((state * XORSHIFT_MULTIPLIER) >> 32);
+}
+
+int get_random_index(t_random_generator *generator, int range) {
+    return (int) (((uint64_t) get_random_number(generator) * (uint64_t) range) >> 32);
+}
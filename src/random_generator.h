@@ -0,0 +1,44 @@
+/**************************************************************************************************
+ * @file random_generator.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for random_generator module, exports a seeded reentrant pseudo random generator.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_RANDOM_GENERATOR_H
+#define MINESWEEPERSOLVER_RANDOM_GENERATOR_H
+
+#include <stdint.h>
+
+/**
+ * Pseudo random generator state (xorshift64*).
+ * Every owner keeps its own state, so generators never share global state (unlike rand()).
+ */
+typedef struct {
+    uint64_t state;
+} t_random_generator;
+
+/**
+ * @brief Seed a random generator.
+ * @param generator Pointer to generator to seed.
+ * @param seed The seed, equal seeds produce equal sequences.
+ * @return Void.
+ */
+void seed_random_generator(t_random_generator *generator, uint64_t seed);
+
+/**
+ * @brief Get next 32 bits pseudo random number.
+ * @param generator Pointer to generator.
+ * @return Pseudo random number.
+ */
+uint32_t get_random_number(t_random_generator *generator);
+
+/**
+ * @brief Get a uniform pseudo random index in range [0, range).
+ * @param generator Pointer to generator.
+ * @param range Positive range size.
+ * @return Pseudo random index.
+ */
+int get_random_index(t_random_generator *generator, int range);
+
+#endif //MINESWEEPERSOLVER_RANDOM_GENERATOR_H
@@ -0,0 +1,299 @@
+/**************************************************************************************************
+ * @file reduction.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief reduction module, removes duplicate equations and subtracts nested equations of a component.
+ * Neighboring numbers share most of their unknowns, so many equations are equal or nested. Subtracting a nested
+ * equation keeps the system equivalent, while rows get sparser and duplicates (dropped) appear.
+**************************************************************************************************/
+#include <stdlib.h>
+#include "reduction.h"
+
+t_error_code initialize_reduction(t_reduction *reduction, t_board_size board_size) {
+    int cells_number = board_size.rows * board_size.cols;
+    reduction->hash_capacity = 1;
+    while (reduction->hash_capacity < 2 * cells_number)
+        reduction->hash_capacity <<= 1;
+    reduction->hash_mask = 0;
+    reduction->equations = (t_equation *) malloc(sizeof(t_equation) * cells_number);
+    reduction->is_alive = (bool *) malloc(sizeof(bool) * cells_number);
+    reduction->variables_equations = (int *) malloc(sizeof(int) * cells_number * NEIGHBORS_NUMBER);
+    reduction->variables_equations_number = (int *) malloc(sizeof(int) * cells_number);
+    reduction->hash_table = (int *) malloc(sizeof(int) * reduction->hash_capacity);
+    reduction->queue = (int *) malloc(sizeof(int) * cells_number);
+    reduction->is_queued = (bool *) malloc(sizeof(bool) * cells_number);
+    if (!reduction->equations || !reduction->is_alive || !reduction->variables_equations ||
+        !reduction->variables_equations_number || !reduction->hash_table || !reduction->queue ||
+        !reduction->is_queued) {
+        free_reduction(reduction);
+        return ERROR_REDUCTION_MEMORY_ALLOC;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_reduction(t_reduction *reduction) {
+    free(reduction->equations);
+    free(reduction->is_alive);
+    free(reduction->variables_equations);
+    free(reduction->variables_equations_number);
+    free(reduction->hash_table);
+    free(reduction->queue);
+    free(reduction->is_queued);
+    reduction->equations = NULL;
+    reduction->is_alive = NULL;
+    reduction->variables_equations = NULL;
+    reduction->variables_equations_number = NULL;
+    reduction->hash_table = NULL;
+    reduction->queue = NULL;
+    reduction->is_queued = NULL;
+}
+
+/**
+ * @brief Hash the variables set of an equation.
+ * @param equation The equation (sorted variables).
+ * @return Hash value.
+ */
+unsigned int hash_variables_set(const t_equation *equation) {
+    unsigned int hash = (unsigned int) equation->variables_number;
+    for (int k = 0; k < equation->variables_number; k++)
+        hash = hash * 31u + (unsigned int) equation->variables[k];
+    return hash * 2654435761u;
+}
+
+/**
+ * @brief Is the variables set of two equations equal.
+ * @param first First equation (sorted variables).
+ * @param second Second equation (sorted variables).
+ * @return Boolean, true if sets are equal.
+ */
+bool is_same_variables_set(const t_equation *first, const t_equation *second) {
+    if (first->variables_number != second->variables_number)
+        return false;
+    for (int k = 0; k < first->variables_number; k++)
+        if (first->variables[k] != second->variables[k])
+            return false;
+    return true;
+}
+
+/**
+ * @brief Find the hash slot of an equation variables set (linear probing).
+ * @param reduction Pointer to reduction.
+ * @param equation The equation (sorted variables).
+ * @return Slot of an equation with the same set, or the empty slot to insert it in.
+ */
+int find_hash_slot(t_reduction *reduction, const t_equation *equation) {
+    for (unsigned int slot = hash_variables_set(equation) & reduction->hash_mask;;
+         slot = (slot + 1) & reduction->hash_mask) {
+        int index = reduction->hash_table[slot];
+        if (index == REDUCTION_HASH_EMPTY || is_same_variables_set(&reduction->equations[index], equation))
+            return (int) slot;
+    }
+}
+
+/**
+ * @brief Empty a hash slot, shifting back the later entries of its probe run (so no tombstones are needed).
+ * @param reduction Pointer to reduction.
+ * @param slot Slot to empty.
+ * @return Void.
+ */
+void remove_hash_slot(t_reduction *reduction, int slot) {
+    int mask = reduction->hash_mask;
+    for (int next_slot = (slot + 1) & mask; reduction->hash_table[next_slot] != REDUCTION_HASH_EMPTY;
+         next_slot = (next_slot + 1) & mask) {
+        int home_slot = (int) (hash_variables_set(&reduction->equations[reduction->hash_table[next_slot]]) & mask);
+        // The entry may move back only if its home slot is not cyclically within (slot, next_slot].
+        if (((next_slot - home_slot) & mask) >= ((next_slot - slot) & mask)) {
+            reduction->hash_table[slot] = reduction->hash_table[next_slot];
+            slot = next_slot;
+        }
+    }
+    reduction->hash_table[slot] = REDUCTION_HASH_EMPTY;
+}
+
+/**
+ * @brief Add an equation to the lists of its variables.
+ * @param reduction Pointer to reduction.
+ * @param index Equation index.
+ * @param first_variable First variable of component.
+ * @return Void.
+ */
+void link_equation_variables(t_reduction *reduction, int index, int first_variable) {
+    t_equation *equation = &reduction->equations[index];
+    for (int k = 0; k < equation->variables_number; k++) {
+        int variable = equation->variables[k] - first_variable;
+        int *number = &reduction->variables_equations_number[variable];
+        reduction->variables_equations[variable * NEIGHBORS_NUMBER + (*number)++] = index;
+    }
+}
+
+/**
+ * @brief Remove an equation from the list of a variable.
+ * @param reduction Pointer to reduction.
+ * @param index Equation index.
+ * @param variable Variable (component ordered index).
+ * @return Void.
+ */
+void unlink_equation_variable(t_reduction *reduction, int index, int variable) {
+    int *equations = reduction->variables_equations + variable * NEIGHBORS_NUMBER;
+    int *number = &reduction->variables_equations_number[variable];
+    for (int i = 0; i < *number; i++)
+        if (equations[i] == index) {
+            equations[i] = equations[--(*number)];
+            return;
+        }
+}
+
+/**
+ * @brief Add an equation to worklist, unless it is already there.
+ * @param reduction Pointer to reduction.
+ * @param queue_end Pointer to worklist end (total number of ever queued equations).
+ * @param equations_number Number of component equations (worklist size).
+ * @param index Equation index.
+ * @return Void.
+ */
+void queue_reduced_equation(t_reduction *reduction, int *queue_end, int equations_number, int index) {
+    if (reduction->is_queued[index])
+        return;
+    reduction->is_queued[index] = true;
+    reduction->queue[(*queue_end)++ % equations_number] = index;
+}
+
+/**
+ * @brief Is the variables set of an equation a subset of another's.
+ * @param subset Candidate subset equation (sorted variables).
+ * @param superset Candidate superset equation (sorted variables).
+ * @return Boolean, true if subset.
+ */
+bool is_variables_subset(const t_equation *subset, const t_equation *superset) {
+    int k = 0;
+    for (int j = 0; j < superset->variables_number && k < subset->variables_number; j++)
+        if (superset->variables[j] == subset->variables[k])
+            k++;
+    return k == subset->variables_number;
+}
+
+/**
+ * @brief Subtract a nested equation from an equation, and re-hash it (dropping it if it became a duplicate).
+ * @param reduction Pointer to reduction.
+ * @param subset_index Nested equation index.
+ * @param index Equation index.
+ * @param first_variable First variable of component.
+ * @return Boolean, true if equation is still alive.
+ */
+bool subtract_equation(t_reduction *reduction, int subset_index, int index, int first_variable) {
+    t_equation *subset = &reduction->equations[subset_index];
+    t_equation *equation = &reduction->equations[index];
+    remove_hash_slot(reduction, find_hash_slot(reduction, equation));
+    int variables_number = 0, k = 0;
+    for (int j = 0; j < equation->variables_number; j++) {
+        if (k < subset->variables_number && equation->variables[j] == subset->variables[k]) {
+            unlink_equation_variable(reduction, index, equation->variables[j] - first_variable);
+            k++;
+        } else
+            equation->variables[variables_number++] = equation->variables[j];
+    }
+    equation->variables_number = variables_number;
+    equation->bias -= subset->bias;
+    int slot = find_hash_slot(reduction, equation);
+    if (reduction->hash_table[slot] != REDUCTION_HASH_EMPTY) {
+        for (int j = 0; j < equation->variables_number; j++)
+            unlink_equation_variable(reduction, index, equation->variables[j] - first_variable);
+        reduction->is_alive[index] = false;
+        return false;
+    }
+    reduction->hash_table[slot] = index;
+    return true;
+}
+
+/**
+ * @brief Subtract an equation from all the alive equations it is nested in.
+ * Every changed equation, and the equations that share its variables, are queued again.
+ * @param reduction Pointer to reduction.
+ * @param index Equation index.
+ * @param first_variable First variable of component.
+ * @param queue_end Pointer to worklist end.
+ * @param equations_number Number of component equations.
+ * @return Void.
+ */
+void reduce_supersets(t_reduction *reduction, int index, int first_variable, int *queue_end, int equations_number) {
+    t_equation *equation = &reduction->equations[index];
+    int candidates[NEIGHBORS_NUMBER * NEIGHBORS_NUMBER];
+    int candidates_number = 0;
+    for (int k = 0; k < equation->variables_number; k++) {
+        int variable = equation->variables[k] - first_variable;
+        for (int i = 0; i < reduction->variables_equations_number[variable]; i++) {
+            int candidate = reduction->variables_equations[variable * NEIGHBORS_NUMBER + i];
+            bool is_listed = candidate == index;
+            for (int j = 0; j < candidates_number && !is_listed; j++)
+                is_listed = candidates[j] == candidate;
+            if (!is_listed)
+                candidates[candidates_number++] = candidate;
+        }
+    }
+    for (int i = 0; i < candidates_number; i++) {
+        t_equation *candidate = &reduction->equations[candidates[i]];
+        if (!reduction->is_alive[candidates[i]] || candidate->variables_number <= equation->variables_number ||
+            !is_variables_subset(equation, candidate))
+            continue;
+        if (!subtract_equation(reduction, index, candidates[i], first_variable))
+            continue;
+        queue_reduced_equation(reduction, queue_end, equations_number, candidates[i]);
+        for (int k = 0; k < candidate->variables_number; k++) {
+            int variable = candidate->variables[k] - first_variable;
+            for (int j = 0; j < reduction->variables_equations_number[variable]; j++)
+                queue_reduced_equation(reduction, queue_end, equations_number,
+                                       reduction->variables_equations[variable * NEIGHBORS_NUMBER + j]);
+        }
+    }
+}
+
+/**
+ * @brief Copy an equation with its variables sorted (insertion sort, at most NEIGHBORS_NUMBER variables).
+ * @param source Source equation.
+ * @param destination Destination equation.
+ * @return Void.
+ */
+void copy_sorted_equation(const t_equation *source, t_equation *destination) {
+    *destination = *source;
+    for (int k = 1; k < destination->variables_number; k++) {
+        int variable = destination->variables[k], j = k - 1;
+        for (; j >= 0 && destination->variables[j] > variable; j--)
+            destination->variables[j + 1] = destination->variables[j];
+        destination->variables[j + 1] = variable;
+    }
+}
+
+int reduce_equations(t_reduction *reduction, const t_equation *equations, t_component component) {
+    int equations_number = component.equations_number;
+    int queue_start = 0, queue_end = 0, hash_slots = 1;
+    while (hash_slots < 2 * equations_number)
+        hash_slots <<= 1;
+    reduction->hash_mask = hash_slots - 1;
+    for (int slot = 0; slot < hash_slots; slot++)
+        reduction->hash_table[slot] = REDUCTION_HASH_EMPTY;
+    for (int variable = 0; variable < component.variables_number; variable++)
+        reduction->variables_equations_number[variable] = 0;
+    for (int i = 0; i < equations_number; i++) {
+        copy_sorted_equation(&equations[i], &reduction->equations[i]);
+        reduction->is_queued[i] = false;
+        int slot = find_hash_slot(reduction, &reduction->equations[i]);
+        reduction->is_alive[i] = reduction->hash_table[slot] == REDUCTION_HASH_EMPTY;
+        if (!reduction->is_alive[i])
+            continue;
+        reduction->hash_table[slot] = i;
+        link_equation_variables(reduction, i, component.first_variable);
+        queue_reduced_equation(reduction, &queue_end, equations_number, i);
+    }
+    while (queue_start < queue_end) {
+        int index = reduction->queue[queue_start++ % equations_number];
+        reduction->is_queued[index] = false;
+        if (reduction->is_alive[index])
+            reduce_supersets(reduction, index, component.first_variable, &queue_end, equations_number);
+    }
+    int reduced_number = 0;
+    for (int i = 0; i < equations_number; i++)
+        if (reduction->is_alive[i])
+            reduction->equations[reduced_number++] = reduction->equations[i];
+    return reduced_number;
+}
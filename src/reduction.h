@@ -0,0 +1,62 @@
+/**************************************************************************************************
+ * @file reduction.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for reduction module, exports duplicate and subset reduction of component equations.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_REDUCTION_H
+#define MINESWEEPERSOLVER_REDUCTION_H
+
+#include <stdbool.h>
+#include "error_codes.h"
+#include "board.h"
+#include "frontier.h"
+
+#define REDUCTION_HASH_EMPTY -1
+
+/**
+ * Struct for reduction scratch buffers, allocated once in the size of board cells.
+ */
+struct reduction {
+    t_equation *equations;              // Reduced equations, with sorted variables.
+    bool *is_alive;                     // False for equations dropped as duplicates.
+    int *variables_equations;           // NEIGHBORS_NUMBER reduced equations for every component variable.
+    int *variables_equations_number;
+    int *hash_table;                    // Open addressing table of equations indexes, by variables set.
+    int hash_capacity;                  // Allocated slots (power of two), a prefix of them is used per component.
+    int hash_mask;                      // Used slots mask of current component.
+    int *queue;                         // Worklist of equations indexes (cyclic).
+    bool *is_queued;
+};
+typedef struct reduction t_reduction;
+
+/**
+ * @brief Initialize reduction buffers.
+ * @param reduction Pointer to reduction.
+ * @param board_size Board size.
+ * @return Error code.
+ */
+t_error_code initialize_reduction(t_reduction *reduction, t_board_size board_size);
+
+/**
+ * @brief Free reduction buffers.
+ * @param reduction Pointer to reduction.
+ * @return Void.
+ */
+void free_reduction(t_reduction *reduction);
+
+/**
+ * @brief Reduce the equations of a component, before elimination.
+ * Equations are hashed by their sorted variables sets, so duplicates are dropped. Once an equation variables set
+ * is a subset of another's, it is subtracted from the other (the 1-2-1 patterns), and the worklist runs until no
+ * equation changes. The reduced equations are equivalent to the component equations, and are usually fewer and
+ * sparser, and every reduced equation whose bias is 0 or its number of variables is deterministic.
+ * @param reduction Pointer to reduction.
+ * @param equations Component equations.
+ * @param component The component.
+ * @return Number of reduced equations (at the start of reduction equations).
+ */
+int reduce_equations(t_reduction *reduction, const t_equation *equations, t_component component);
+
+#endif //MINESWEEPERSOLVER_REDUCTION_H
@@ -0,0 +1,188 @@
+/**************************************************************************************************
+ * @file simulator.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief simulator module, a pure C Minesweeper game engine.
+ * The engine handles mines placement (on first reveal), reveals, flood-fill cascades over empty cells,
+ * flags and win/loss detection. It has no dependency on Windows, so the whole solver loop
+ * can run headless, at the speed of the board analyzer.
+**************************************************************************************************/
+#include <stdlib.h>
+#include "common.h"
+#include "bitboard.h"
+#include "simulator.h"
+
+#define NEIGHBORS_NUMBER 8
+
+/**
+ * Macro for accessing game cell by index of board cell.
+ */
+#define GAME_CELL_INDEX(game, row, col) ((row) * (game)->board_size.cols + (col))
+
+static const int neighbor_row_offsets[NEIGHBORS_NUMBER] = {-1, -1, -1, 0, 0, 1, 1, 1};
+static const int neighbor_col_offsets[NEIGHBORS_NUMBER] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+/**
+ * @brief Get number of board cells in game.
+ * @param game Pointer to game.
+ * @return Number of cells.
+ */
+int get_game_cells_number(t_game *game) {
+    return game->board_size.rows * game->board_size.cols;
+}
+
+void reset_game(t_game *game, uint64_t seed) {
+    int cells_number = get_game_cells_number(game);
+    for (int i = 0; i < cells_number; i++) {
+        game->solution[i] = EMPTY_CELL;
+        game->visible[i] = UNKNOWN_CELL;
+    }
+    game->revealed_cells = 0;
+    game->updated_cells = 0;
+    game->is_mines_placed = false;
+    game->status = GAME_ON;
+    seed_random_generator(&game->random_generator, seed);
+}
+
+t_error_code initialize_game(t_game *game, t_board_size board_size, int number_of_mines, uint64_t seed) {
+    int cells_number = board_size.rows * board_size.cols;
+    ASSERT(number_of_mines < cells_number);
+    game->board_size = board_size;
+    game->number_of_mines = number_of_mines;
+    game->solution = (t_cell_type *) malloc(cells_number * sizeof(t_cell_type));
+    game->visible = (t_cell_type *) malloc(cells_number * sizeof(t_cell_type));
+    game->flood_fill_stack = (int *) malloc(cells_number * sizeof(int));
+    game->revealed_order = (int *) malloc(cells_number * sizeof(int));
+    if (!game->solution || !game->visible || !game->flood_fill_stack || !game->revealed_order) {
+        free_game(game);
+        return ERROR_INITIALIZE_GAME_MEMORY_ALLOC;
+    }
+    reset_game(game, seed);
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_game(t_game *game) {
+    free(game->solution);
+    free(game->visible);
+    free(game->flood_fill_stack);
+    free(game->revealed_order);
+    game->solution = NULL;
+    game->visible = NULL;
+    game->flood_fill_stack = NULL;
+    game->revealed_order = NULL;
+}
+
+/**
+ * @brief Place mines uniformly over all cells except the first revealed cell, and count numbers.
+ * Placement is a partial Fisher-Yates shuffle over the cell indexes (flood fill stack is used as scratch).
+ * @param game Pointer to game.
+ * @param first_cell_index Index of first revealed cell, never a mine.
+ * @return Void.
+ */
+void place_mines(t_game *game, int first_cell_index) {
+    int cells_number = get_game_cells_number(game);
+    int *candidates = game->flood_fill_stack;
+    int candidates_number = 0;
+    for (int i = 0; i < cells_number; i++)
+        if (i != first_cell_index)
+            candidates[candidates_number++] = i;
+    for (int mine = 0; mine < game->number_of_mines; mine++) {
+        int chosen = mine + get_random_index(&game->random_generator, candidates_number - mine);
+        int temp = candidates[mine];
+        candidates[mine] = candidates[chosen];
+        candidates[chosen] = temp;
+        game->solution[candidates[mine]] = MINE;
+    }
+    for (int row = 0; row < game->board_size.rows; row++)
+        for (int col = 0; col < game->board_size.cols; col++) {
+            if (game->solution[GAME_CELL_INDEX(game, row, col)] == MINE)
+                continue;
+            int mines_counter = 0;
+            for (int k = 0; k < NEIGHBORS_NUMBER; k++) {
+                int neighbor_row = row + neighbor_row_offsets[k];
+                int neighbor_col = col + neighbor_col_offsets[k];
+                if (neighbor_row >= 0 && neighbor_row < game->board_size.rows &&
+                    neighbor_col >= 0 && neighbor_col < game->board_size.cols &&
+                    game->solution[GAME_CELL_INDEX(game, neighbor_row, neighbor_col)] == MINE)
+                    mines_counter++;
+            }
+            game->solution[GAME_CELL_INDEX(game, row, col)] = (t_cell_type) mines_counter;
+        }
+    game->is_mines_placed = true;
+}
+
+/**
+ * @brief Reveal a cell, cascading over neighbors of empty cells (flood fill).
+ * @param game Pointer to game.
+ * @param cell The revealed cell.
+ * @return Void.
+ */
+void reveal_cell(t_game *game, t_board_cell cell) {
+    int cell_index = GAME_CELL_INDEX(game, cell.row, cell.col);
+    if (game->visible[cell_index] != UNKNOWN_CELL)
+        return;
+    if (!game->is_mines_placed)
+        place_mines(game, cell_index);
+    if (game->solution[cell_index] == MINE) {
+        game->status = LOST;
+        return;
+    }
+    int stack_size = 0;
+    game->visible[cell_index] = game->solution[cell_index];
+    game->revealed_order[game->revealed_cells++] = cell_index;
+    game->flood_fill_stack[stack_size++] = cell_index;
+    while (stack_size > 0) {
+        int current_index = game->flood_fill_stack[--stack_size];
+        if (game->solution[current_index] != EMPTY_CELL)
+            continue;
+        int row = current_index / game->board_size.cols;
+        int col = current_index % game->board_size.cols;
+        for (int k = 0; k < NEIGHBORS_NUMBER; k++) {
+            int neighbor_row = row + neighbor_row_offsets[k];
+            int neighbor_col = col + neighbor_col_offsets[k];
+            if (neighbor_row < 0 || neighbor_row >= game->board_size.rows ||
+                neighbor_col < 0 || neighbor_col >= game->board_size.cols)
+                continue;
+            int neighbor_index = GAME_CELL_INDEX(game, neighbor_row, neighbor_col);
+            if (game->visible[neighbor_index] != UNKNOWN_CELL)
+                continue;
+            game->visible[neighbor_index] = game->solution[neighbor_index];
+            game->revealed_order[game->revealed_cells++] = neighbor_index;
+            game->flood_fill_stack[stack_size++] = neighbor_index;
+        }
+    }
+    if (game->revealed_cells == get_game_cells_number(game) - game->number_of_mines)
+        game->status = WIN;
+}
+
+t_error_code simulate_moves(t_game *game, t_moves moves) {
+    t_error_code error_code = RETURN_CODE_SUCCESS;
+    for (int i = 0; i < moves.number_of_moves && game->status == GAME_ON; i++) {
+        t_move move = moves.moves[i];
+        if (move.cell.row < 0 || move.cell.row >= game->board_size.rows ||
+            move.cell.col < 0 || move.cell.col >= game->board_size.cols) {
+            error_code = ERROR_SIMULATE_MOVE_OUT_OF_BOARD;
+            goto lblCleanup;
+        }
+        int cell_index = GAME_CELL_INDEX(game, move.cell.row, move.cell.col);
+        if (move.is_mine) {
+            if (game->visible[cell_index] == UNKNOWN_CELL)
+                game->visible[cell_index] = MINE;
+        } else
+            reveal_cell(game, move.cell);
+    }
+    lblCleanup:
+    return error_code;
+}
+
+void update_board_from_game(t_game *game, t_board board, t_game_status *game_status) {
+    *game_status = game->status;
+    if (*game_status != GAME_ON)
+        return;
+    for (; game->updated_cells < game->revealed_cells; game->updated_cells++) {
+        int i = game->revealed_order[game->updated_cells];
+        if (board.cells[i] == UNKNOWN_CELL)
+            set_board_cell(board, i / board.size.cols, i % board.size.cols, game->visible[i]);
+    }
+}
@@ -0,0 +1,85 @@
+/**************************************************************************************************
+ * @file simulator.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for simulator module, an in-process Minesweeper game engine.
+ * The simulator replaces Minesweeper X window (commander and board detection) in headless runs.
+ * Every game is independent, so many games may be simulated at once.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_SIMULATOR_H
+#define MINESWEEPERSOLVER_SIMULATOR_H
+
+#include <stdbool.h>
+#include "error_codes.h"
+#include "board.h"
+#include "board_analyzer.h"
+#include "random_generator.h"
+
+/**
+ * Struct for a simulated game state.
+ */
+struct game {
+    t_board_size board_size;
+    int number_of_mines;
+    t_cell_type *solution;      // Full board, numbers and mines (valid once mines are placed).
+    t_cell_type *visible;       // Board as seen by the player, unknowns, flags (MINE) and revealed cells.
+    int *flood_fill_stack;      // Cell indexes stack for revealing empty cells cascades.
+    int *revealed_order;        // Indexes of revealed cells, in order of reveal.
+    int revealed_cells;
+    int updated_cells;          // Number of revealed cells (in order) already copied to the board.
+    bool is_mines_placed;
+    t_game_status status;
+    t_random_generator random_generator;
+};
+typedef struct game t_game;
+
+/**
+ * @brief Initialize a simulated game.
+ * Mines are placed on first reveal, so the first revealed cell is never a mine (as in Minesweeper X).
+ * @param game Pointer to game to initialize.
+ * @param board_size Board size.
+ * @param number_of_mines Number of mines in game.
+ * @param seed Seed of mines placement, equal seeds and moves produce equal games.
+ * @return Error code.
+ */
+t_error_code initialize_game(t_game *game, t_board_size board_size, int number_of_mines, uint64_t seed);
+
+/**
+ * @brief Restart a simulated game (with the same size and number of mines) using a new seed.
+ * @param game Pointer to initialized game.
+ * @param seed Seed of mines placement.
+ * @return Void.
+ */
+void reset_game(t_game *game, uint64_t seed);
+
+/**
+ * @brief Free simulated game memory.
+ * @param game Pointer to game.
+ * @return Void.
+ */
+void free_game(t_game *game);
+
+/**
+ * @brief Apply a series of moves to the game.
+ * Clear moves reveal cells (with cascades over empty cells), mine moves flag cells.
+ * Moves memory is owned by the solver turn arena, and is not freed.
+ * @param game Pointer to game.
+ * @param moves Moves to apply.
+ * @return Error code.
+ */
+t_error_code simulate_moves(t_game *game, t_moves moves);
+
+/**
+ * @brief Update board state (cells) and status from the simulated game.
+ * Equivalent to update_board, but cells are read from the engine instead of a screenshot.
+ * Only the cells revealed since the last update are copied, so an update costs as much as the change, and the board
+ * must be the one of all former updates since the game was (re)started.
+ * @param game Pointer to game.
+ * @param board The board.
+ * @param game_status Pointer for game status to update.
+ * @return Void.
+ */
+void update_board_from_game(t_game *game, t_board board, t_game_status *game_status);
+
+#endif //MINESWEEPERSOLVER_SIMULATOR_H
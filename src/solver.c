@@ -0,0 +1,235 @@
+/**************************************************************************************************
+ * @file solver.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief solver module, solver context life cycle and scratch buffers.
+**************************************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "solver.h"
+#include "board_analyzer.h"
+#include "timer.h"
+
+/**
+ * @brief Initialize the scratch buffers of a component workspace.
+ * @param workspace Pointer to workspace.
+ * @param board_size Board size.
+ * @return Error code.
+ */
+t_error_code initialize_component_workspace(t_component_workspace *workspace, t_board_size board_size) {
+    workspace->equations_data = NULL;
+    workspace->equations_capacity = 0;
+    workspace->compact_equations_buffer = NULL;
+    workspace->compact_equations_capacity = 0;
+    t_error_code reduction_error_code = initialize_reduction(&workspace->reduction, board_size);
+    t_error_code sparse_matrix_error_code = initialize_sparse_matrix(&workspace->sparse_matrix, board_size);
+    return reduction_error_code ? reduction_error_code : sparse_matrix_error_code;
+}
+
+/**
+ * @brief Free the scratch buffers of a component workspace.
+ * @param workspace Pointer to workspace.
+ * @return Void.
+ */
+void free_component_workspace(t_component_workspace *workspace) {
+    free(workspace->equations_data);
+    free(workspace->compact_equations_buffer);
+    free_reduction(&workspace->reduction);
+    free_sparse_matrix(&workspace->sparse_matrix);
+    workspace->equations_data = NULL;
+    workspace->equations_capacity = 0;
+    workspace->compact_equations_buffer = NULL;
+    workspace->compact_equations_capacity = 0;
+}
+
+/**
+ * @brief Free the buffers of solver workers.
+ * @param workspaces Workspace of every worker (may be NULL).
+ * @param workspaces_number Number of workspaces.
+ * @param probability_engine Pointer to probability engine.
+ * @return Void.
+ */
+void free_worker_buffers(t_component_workspace *workspaces, int workspaces_number,
+                         t_probability_engine *probability_engine) {
+    for (int i = 0; workspaces && i < workspaces_number; i++)
+        free_component_workspace(&workspaces[i]);
+    free(workspaces);
+    free_probability_engine(probability_engine);
+}
+
+/**
+ * @brief Free the thread pool of solver, and the buffers of its workers.
+ * @param solver Pointer to solver.
+ * @return Void.
+ */
+void free_solver_workers(t_solver *solver) {
+    free_thread_pool(&solver->thread_pool);
+    free_worker_buffers(solver->workspaces, solver->workspaces_number, &solver->probability_engine);
+    solver->workspaces = NULL;
+    solver->workspaces_number = 0;
+}
+
+/**
+ * @brief Initialize the buffers of solver workers (a workspace and a probability search for every worker), in place
+ * of the current ones (which are not freed).
+ * @param solver Pointer to solver.
+ * @param threads_number Number of threads, including the calling thread.
+ * @return Error code, on failure no buffers are left allocated.
+ */
+t_error_code initialize_worker_buffers(t_solver *solver, int threads_number) {
+    t_error_code workspaces_error_code = RETURN_CODE_SUCCESS;
+    solver->workspaces_number = threads_number;
+    solver->workspaces = (t_component_workspace *) calloc(threads_number, sizeof(t_component_workspace));
+    for (int i = 0; solver->workspaces && i < threads_number; i++) {
+        t_error_code error_code = initialize_component_workspace(&solver->workspaces[i], solver->board_size);
+        if (!workspaces_error_code)
+            workspaces_error_code = error_code;
+    }
+    if (!solver->workspaces)
+        workspaces_error_code = ERROR_THREAD_POOL_MEMORY_ALLOC;
+    t_error_code probability_error_code = initialize_probability_engine(&solver->probability_engine,
+                                                                        solver->board_size, threads_number);
+    if (workspaces_error_code || probability_error_code) {
+        free_worker_buffers(solver->workspaces, solver->workspaces_number, &solver->probability_engine);
+        solver->workspaces = NULL;
+        solver->workspaces_number = 0;
+        return workspaces_error_code ? workspaces_error_code : probability_error_code;
+    }
+    solver->probability_engine.component_cache = &solver->component_cache;
+    solver->probability_engine.thread_pool = &solver->thread_pool;
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Initialize the thread pool of solver, and the buffers of its workers.
+ * @param solver Pointer to solver, with no workers.
+ * @param threads_number Number of threads, including the calling thread.
+ * @return Error code.
+ */
+t_error_code initialize_solver_workers(t_solver *solver, int threads_number) {
+    t_error_code thread_pool_error_code = initialize_thread_pool(&solver->thread_pool, threads_number);
+    t_error_code buffers_error_code = initialize_worker_buffers(solver, threads_number);
+    if (thread_pool_error_code || buffers_error_code) {
+        free_solver_workers(solver);
+        return thread_pool_error_code ? thread_pool_error_code : buffers_error_code;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+t_error_code initialize_solver(t_solver *solver, t_board_size board_size, int number_of_mines, uint64_t seed) {
+    int cells_number = board_size.rows * board_size.cols;
+    solver->board_size = board_size;
+    solver->number_of_mines = number_of_mines;
+    seed_random_generator(&solver->random_generator, seed);
+    solver->variables_deductions = (signed char *) malloc(sizeof(signed char) * cells_number);
+    solver->component_results = (t_component_result *) malloc(sizeof(t_component_result) * cells_number);
+    solver->elimination_mode = ELIMINATION_GCD_NORMALIZED;
+    solver->endgame_node_budget = ENDGAME_DEFAULT_NODE_BUDGET;
+    solver->endgame_time_budget = 0;
+    solver->turn_deadline = NO_DEADLINE;
+    t_error_code frontier_error_code = initialize_frontier(&solver->frontier, board_size);
+    t_error_code local_rules_error_code = initialize_local_rules(&solver->local_rules, board_size);
+    t_error_code workers_error_code = initialize_solver_workers(solver, 1);
+    t_error_code component_cache_error_code = initialize_component_cache(&solver->component_cache);
+    t_error_code endgame_error_code = initialize_endgame(&solver->endgame);
+    // A turn has at most a move for every cell.
+    t_error_code arena_error_code = initialize_arena(&solver->turn_arena, sizeof(t_move) * board_size.rows *
+                                                                          board_size.cols + ARENA_ALIGNMENT);
+    if (frontier_error_code || local_rules_error_code || workers_error_code || component_cache_error_code ||
+        endgame_error_code || arena_error_code) {
+        free_solver(solver);
+        if (frontier_error_code)
+            return frontier_error_code;
+        if (local_rules_error_code)
+            return local_rules_error_code;
+        if (workers_error_code)
+            return workers_error_code;
+        if (component_cache_error_code)
+            return component_cache_error_code;
+        return endgame_error_code ? endgame_error_code : arena_error_code;
+    }
+    if (!solver->variables_deductions || !solver->component_results) {
+        free_solver(solver);
+        return ERROR_INITIALIZE_MATRIX_MEMORY_ALLOC;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_solver(t_solver *solver) {
+    free(solver->variables_deductions);
+    free(solver->component_results);
+    free_frontier(&solver->frontier);
+    free_local_rules(&solver->local_rules);
+    free_solver_workers(solver);
+    free_component_cache(&solver->component_cache);
+    free_endgame(&solver->endgame);
+    free_arena(&solver->turn_arena);
+    solver->variables_deductions = NULL;
+    solver->component_results = NULL;
+}
+
+void set_endgame_node_budget(t_solver *solver, long node_budget) {
+    solver->endgame_node_budget = node_budget;
+}
+
+void set_endgame_time_budget(t_solver *solver, uint64_t time_budget) {
+    solver->endgame_time_budget = time_budget;
+}
+
+t_error_code set_solver_threads(t_solver *solver, int threads_number) {
+    t_component_workspace *former_workspaces = solver->workspaces;
+    int former_workspaces_number = solver->workspaces_number;
+    t_probability_engine former_probability_engine = solver->probability_engine;
+    threads_number = threads_number > 1 ? threads_number : 1;
+    // New buffers are allocated before the former ones are freed, so a failure keeps the former workers.
+    t_error_code error_code = initialize_worker_buffers(solver, threads_number);
+    if (error_code) {
+        solver->workspaces = former_workspaces;
+        solver->workspaces_number = former_workspaces_number;
+        solver->probability_engine = former_probability_engine;
+        return error_code;
+    }
+    free_worker_buffers(former_workspaces, former_workspaces_number, &former_probability_engine);
+    free_thread_pool(&solver->thread_pool);
+    error_code = initialize_thread_pool(&solver->thread_pool, threads_number);
+    // A single worker pool starts no threads, so the solver is left solving on the calling thread.
+    if (error_code)
+        initialize_thread_pool(&solver->thread_pool, 1);
+    return error_code;
+}
+
+t_integer_matrix get_equations_matrix(t_component_workspace *workspace, t_matrix_size matrix_size, int64_t fill) {
+    t_integer_matrix matrix = {NULL, matrix_size};
+    size_t required_capacity = (size_t) matrix_size.rows * matrix_size.cols;
+    if (!workspace->equations_data || required_capacity > workspace->equations_capacity) {
+        size_t capacity = required_capacity ? required_capacity : 1;
+        t_integer_data data = (t_integer_data) realloc(workspace->equations_data, sizeof(int64_t) * capacity);
+        if (!data)
+            return matrix;
+        workspace->equations_data = data;
+        workspace->equations_capacity = capacity;
+    }
+    matrix.data = workspace->equations_data;
+    reset_integer_matrix(matrix, fill);
+    return matrix;
+}
+
+t_compact_matrix get_compact_equations_matrix(t_component_workspace *workspace, t_matrix_size matrix_size) {
+    t_compact_matrix matrix = {NULL, NULL, matrix_size, get_compact_row_stride(matrix_size.cols)};
+    size_t rows_bytes = sizeof(int16_t) * (size_t) matrix_size.rows * matrix.row_stride;
+    size_t required_capacity = rows_bytes + sizeof(int32_t) * matrix_size.rows + COMPACT_ROW_ALIGNMENT;
+    if (!workspace->compact_equations_buffer || required_capacity > workspace->compact_equations_capacity) {
+        void *buffer = realloc(workspace->compact_equations_buffer, required_capacity);
+        if (!buffer)
+            return matrix;
+        workspace->compact_equations_buffer = buffer;
+        workspace->compact_equations_capacity = required_capacity;
+    }
+    uintptr_t address = (uintptr_t) workspace->compact_equations_buffer;
+    address = (address + COMPACT_ROW_ALIGNMENT - 1) & ~((uintptr_t) COMPACT_ROW_ALIGNMENT - 1);
+    memset((void *) address, 0, required_capacity - COMPACT_ROW_ALIGNMENT);
+    matrix.data = (t_compact_data) address;
+    matrix.biases = (int32_t *) (address + rows_bytes);
+    return matrix;
+}
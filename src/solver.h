@@ -0,0 +1,150 @@
+/**************************************************************************************************
+ * @file solver.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for solver module, exports the solver context.
+ * The solver context carries all the state a single game requires (dimensions, random generator
+ * and scratch buffers), so independent games may be solved at once, on different threads.
+ * A single game may also be solved over several threads (set_solver_threads), which solve independent frontier
+ * components at once, each with its own component workspace.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_SOLVER_H
+#define MINESWEEPERSOLVER_SOLVER_H
+
+#include <stdint.h>
+#include "error_codes.h"
+#include "board.h"
+#include "matrix.h"
+#include "frontier.h"
+#include "local_rules.h"
+#include "reduction.h"
+#include "sparse_matrix.h"
+#include "probability.h"
+#include "component_cache.h"
+#include "endgame.h"
+#include "random_generator.h"
+#include "arena.h"
+#include "thread_pool.h"
+
+#define DEDUCTION_UNDECIDED COMPONENT_CACHE_UNDECIDED
+
+/**
+ * Struct for scratch buffers of solving a single component, one for every worker thread of the solver.
+ */
+struct component_workspace {
+    t_reduction reduction;              // Duplicate and subset reduction of component equations.
+    t_sparse_matrix sparse_matrix;      // Sparse elimination of large components.
+    t_component_key component_key;      // Canonical form of solved component, for the component cache.
+    t_integer_data equations_data;      // Scratch buffer for equations matrix data.
+    size_t equations_capacity;          // Number of integers allocated in equations_data.
+    void *compact_equations_buffer;     // Scratch buffer for compact equations matrix (rows and biases).
+    size_t compact_equations_capacity;  // Number of bytes allocated in compact_equations_buffer.
+};
+typedef struct component_workspace t_component_workspace;
+
+/**
+ * Struct for elimination result of a single component, written by the worker that solved it.
+ */
+struct component_result {
+    int deterministic_cells;
+    t_error_code error_code;
+    bool is_solved;                     // False if component was not solved (deadline), so it stays pending.
+};
+typedef struct component_result t_component_result;
+
+/**
+ * Struct for solver context, one for every game that is played at once.
+ */
+struct solver {
+    t_board_size board_size;
+    int number_of_mines;
+    t_random_generator random_generator;
+    t_arena turn_arena;                 // Memory of a single turn (moves lists), reset at the start of every turn.
+    signed char *variables_deductions;  // Deduction of every frontier variable (DEDUCTION_UNDECIDED if none).
+    t_frontier frontier;                // Frontier equations system and its independent components.
+    t_local_rules local_rules;          // Single equation deductions state.
+    t_thread_pool thread_pool;          // Threads that solve independent components at once.
+    t_component_workspace *workspaces;  // Workspace of every worker of thread pool.
+    int workspaces_number;
+    t_component_result *component_results; // Elimination result of every component.
+    t_probability_engine probability_engine;
+    t_component_cache component_cache;  // Solutions of recurring components, kept between turns and games.
+    t_endgame endgame;                  // Win probability search of endgame guesses.
+    long endgame_node_budget;           // Endgame search nodes budget of a single guess.
+    uint64_t endgame_time_budget;       // Endgame search time cap of a single guess in nanoseconds, 0 for none.
+    uint64_t turn_deadline;             // Monotonic deadline of current turn, NO_DEADLINE if it is not bounded.
+    t_elimination_mode elimination_mode; // Elimination mode of equations (gcd normalized by default).
+    double color_histogram[NUMBER_OF_COLORS]; // Scratch color histogram for cells detection.
+};
+typedef struct solver t_solver;
+
+/**
+ * @brief Initialize solver context.
+ * @param solver Pointer to solver to initialize.
+ * @param board_size Board size of solved games.
+ * @param number_of_mines Total number of mines in solved games.
+ * @param seed Seed of the solver random generator (used for guesses).
+ * @return Error code.
+ */
+t_error_code initialize_solver(t_solver *solver, t_board_size board_size, int number_of_mines, uint64_t seed);
+
+/**
+ * @brief Free solver context memory.
+ * @param solver Pointer to solver.
+ * @return Void.
+ */
+void free_solver(t_solver *solver);
+
+/**
+ * @brief Set the search nodes budget of endgame guesses (ENDGAME_DEFAULT_NODE_BUDGET by default).
+ * Once the search exceeds its budget, the guess falls back to the safest cell. The budget is counted in search
+ * nodes, so seeded games are reproducible on any machine and load.
+ * @param solver Pointer to solver.
+ * @param node_budget Search nodes budget of a single guess (0 disables endgame search).
+ * @return Void.
+ */
+void set_endgame_node_budget(t_solver *solver, long node_budget);
+
+/**
+ * @brief Set a time cap of endgame guesses search, on top of its nodes budget (none by default).
+ * A capped search depends on the clock, so seeded games are no longer reproducible. The deadline of
+ * get_moves_by_deadline caps the search regardless.
+ * @param solver Pointer to solver.
+ * @param time_budget Search time cap of a single guess, in nanoseconds (0 for none).
+ * @return Void.
+ */
+void set_endgame_time_budget(t_solver *solver, uint64_t time_budget);
+
+/**
+ * @brief Set the number of threads that solve the components of a turn (1 by default, on the calling thread).
+ * Components are solved as independent tasks and merged in component order, so moves don't depend on the number of
+ * threads (MinesweeperThreadsCheck compares them), unless a turn is bounded by the clock (a deadline, or an endgame
+ * time cap). Must be called between games, the worker buffers are allocated again.
+ * @param solver Pointer to solver.
+ * @param threads_number Number of threads, including the calling thread (at least 1).
+ * @return Error code. The solver stays usable on failure: if buffers could not be allocated the former workers are
+ * kept, and if threads could not be started it solves on the calling thread.
+ */
+t_error_code set_solver_threads(t_solver *solver, int threads_number);
+
+/**
+ * @brief Get equations matrix of requested size, backed by the workspace scratch buffer.
+ * The buffer grows when needed, and is reused by next calls.
+ * @param workspace Pointer to component workspace.
+ * @param matrix_size Requested matrix size.
+ * @param fill Value of all matrix cells.
+ * @return Matrix, with NULL data on memory allocation failure.
+ */
+t_integer_matrix get_equations_matrix(t_component_workspace *workspace, t_matrix_size matrix_size, int64_t fill);
+
+/**
+ * @brief Get zeroed compact equations matrix of requested size, backed by the workspace scratch buffer.
+ * Rows are padded and aligned for the SIMD row kernels. The buffer grows when needed, and is reused by next calls.
+ * @param workspace Pointer to component workspace.
+ * @param matrix_size Requested matrix size (equations and variables, without bias).
+ * @return Compact matrix, with NULL data on memory allocation failure.
+ */
+t_compact_matrix get_compact_equations_matrix(t_component_workspace *workspace, t_matrix_size matrix_size);
+
+#endif //MINESWEEPERSOLVER_SOLVER_H
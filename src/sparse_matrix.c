@@ -0,0 +1,343 @@
+/**************************************************************************************************
+ * @file sparse_matrix.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief sparse matrix module, exact elimination of large components over sorted sparse rows.
+ * A component equation has at most NEIGHBORS_NUMBER variables, so the dense matrix of a long component is mostly
+ * zeros. Sparse rows keep their non-zero coefficients only, and columns are ordered along the frontier, so every
+ * pivot row eliminates few rows and adds few coefficients to them.
+**************************************************************************************************/
+#include <stdlib.h>
+#include "matrix.h"
+#include "sparse_matrix.h"
+
+#define SPARSE_UNVISITED -1
+
+t_error_code initialize_sparse_matrix(t_sparse_matrix *matrix, t_board_size board_size) {
+    int cells_number = board_size.rows * board_size.cols;
+    matrix->rows_start = (int *) malloc(sizeof(int) * cells_number);
+    matrix->rows_length = (int *) malloc(sizeof(int) * cells_number);
+    matrix->biases = (int64_t *) malloc(sizeof(int64_t) * cells_number);
+    matrix->bucket_heads = (int *) malloc(sizeof(int) * cells_number);
+    matrix->next_rows = (int *) malloc(sizeof(int) * cells_number);
+    matrix->pivot_rows = (int *) malloc(sizeof(int) * cells_number);
+    matrix->order = (int *) malloc(sizeof(int) * cells_number);
+    matrix->columns = (int *) malloc(sizeof(int) * cells_number);
+    matrix->degrees = (int *) malloc(sizeof(int) * cells_number);
+    matrix->variables_equations = (int *) malloc(sizeof(int) * cells_number * NEIGHBORS_NUMBER);
+    matrix->variables_equations_number = (int *) malloc(sizeof(int) * cells_number);
+    matrix->values = (int *) malloc(sizeof(int) * cells_number);
+    matrix->entries_capacity = (size_t) cells_number * NEIGHBORS_NUMBER;
+    matrix->entries = (t_sparse_entry *) malloc(sizeof(t_sparse_entry) * matrix->entries_capacity);
+    matrix->entries_number = 0;
+    matrix->rows_number = 0;
+    matrix->cols_number = 0;
+    matrix->pivots_number = 0;
+    if (!matrix->rows_start || !matrix->rows_length || !matrix->biases || !matrix->bucket_heads ||
+        !matrix->next_rows || !matrix->pivot_rows || !matrix->order || !matrix->columns || !matrix->degrees ||
+        !matrix->variables_equations || !matrix->variables_equations_number || !matrix->values || !matrix->entries) {
+        free_sparse_matrix(matrix);
+        return ERROR_SPARSE_MATRIX_MEMORY_ALLOC;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_sparse_matrix(t_sparse_matrix *matrix) {
+    free(matrix->rows_start);
+    free(matrix->rows_length);
+    free(matrix->biases);
+    free(matrix->bucket_heads);
+    free(matrix->next_rows);
+    free(matrix->pivot_rows);
+    free(matrix->order);
+    free(matrix->columns);
+    free(matrix->degrees);
+    free(matrix->variables_equations);
+    free(matrix->variables_equations_number);
+    free(matrix->values);
+    free(matrix->entries);
+    matrix->rows_start = NULL;
+    matrix->rows_length = NULL;
+    matrix->biases = NULL;
+    matrix->bucket_heads = NULL;
+    matrix->next_rows = NULL;
+    matrix->pivot_rows = NULL;
+    matrix->order = NULL;
+    matrix->columns = NULL;
+    matrix->degrees = NULL;
+    matrix->variables_equations = NULL;
+    matrix->variables_equations_number = NULL;
+    matrix->values = NULL;
+    matrix->entries = NULL;
+    matrix->entries_capacity = 0;
+}
+
+bool is_sparse_component(const t_equation *equations, t_component component) {
+    long non_zeros = 0;
+    if (component.variables_number < SPARSE_MIN_VARIABLES)
+        return false;
+    for (int i = 0; i < component.equations_number; i++)
+        non_zeros += equations[i].variables_number;
+    return non_zeros < SPARSE_MAX_DENSITY * component.equations_number * component.variables_number;
+}
+
+/**
+ * @brief Make room for more entries in the entries pool.
+ * @param matrix Pointer to sparse matrix.
+ * @param entries_number Number of entries to append.
+ * @return Boolean, true on success, false on memory allocation failure.
+ */
+bool reserve_sparse_entries(t_sparse_matrix *matrix, size_t entries_number) {
+    if (matrix->entries_number + entries_number <= matrix->entries_capacity)
+        return true;
+    size_t capacity = 2 * matrix->entries_capacity;
+    if (capacity < matrix->entries_number + entries_number)
+        capacity = matrix->entries_number + entries_number;
+    t_sparse_entry *entries = (t_sparse_entry *) realloc(matrix->entries, sizeof(t_sparse_entry) * capacity);
+    if (!entries)
+        return false;
+    matrix->entries = entries;
+    matrix->entries_capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Visit the variables graph breadth first (Cuthill-McKee), from a variable, by ascending degree.
+ * Every visited variable is appended to order, and its column is set to its visit index.
+ * @param matrix Pointer to sparse matrix.
+ * @param equations Component equations.
+ * @param first_variable First variable of component.
+ * @param start Start variable (not visited).
+ * @param visited_number Number of variables visited so far.
+ * @return Number of variables visited.
+ */
+int visit_sparse_variables(t_sparse_matrix *matrix, const t_equation *equations, int first_variable, int start,
+                           int visited_number) {
+    int head = visited_number;
+    matrix->columns[start] = visited_number;
+    matrix->order[visited_number++] = start;
+    while (head < visited_number) {
+        int variable = matrix->order[head++], first_neighbor = visited_number;
+        for (int i = 0; i < matrix->variables_equations_number[variable]; i++) {
+            const t_equation *equation = &equations[matrix->variables_equations[variable * NEIGHBORS_NUMBER + i]];
+            for (int k = 0; k < equation->variables_number; k++) {
+                int neighbor = equation->variables[k] - first_variable;
+                if (matrix->columns[neighbor] != SPARSE_UNVISITED)
+                    continue;
+                matrix->columns[neighbor] = visited_number;
+                matrix->order[visited_number++] = neighbor;
+            }
+        }
+        for (int i = first_neighbor + 1; i < visited_number; i++) {
+            int neighbor = matrix->order[i], j = i - 1;
+            for (; j >= first_neighbor && matrix->degrees[matrix->order[j]] > matrix->degrees[neighbor]; j--)
+                matrix->order[j + 1] = matrix->order[j];
+            matrix->order[j + 1] = neighbor;
+        }
+    }
+    return visited_number;
+}
+
+/**
+ * @brief Order component variables by reverse Cuthill-McKee, and set the column of every variable.
+ * Every connected part of the variables graph is visited from a pseudo-peripheral variable: the last variable visited
+ * from its lowest degree variable.
+ * @param matrix Pointer to sparse matrix, with variables equations and degrees set.
+ * @param equations Component equations.
+ * @param component The component.
+ * @return Void.
+ */
+void order_sparse_columns(t_sparse_matrix *matrix, const t_equation *equations, t_component component) {
+    int variables_number = component.variables_number;
+    int visited_number = 0;
+    for (int variable = 0; variable < variables_number; variable++)
+        matrix->columns[variable] = SPARSE_UNVISITED;
+    while (visited_number < variables_number) {
+        int start = SPARSE_UNVISITED;
+        for (int variable = 0; variable < variables_number; variable++)
+            if (matrix->columns[variable] == SPARSE_UNVISITED &&
+                (start == SPARSE_UNVISITED || matrix->degrees[variable] < matrix->degrees[start]))
+                start = variable;
+        int part_visited_number = visit_sparse_variables(matrix, equations, component.first_variable, start,
+                                                         visited_number);
+        int peripheral = matrix->order[part_visited_number - 1];
+        for (int i = visited_number; i < part_visited_number; i++)
+            matrix->columns[matrix->order[i]] = SPARSE_UNVISITED;
+        visited_number = visit_sparse_variables(matrix, equations, component.first_variable, peripheral,
+                                                visited_number);
+    }
+    for (int i = 0; i < variables_number / 2; i++) {
+        int variable = matrix->order[i];
+        matrix->order[i] = matrix->order[variables_number - 1 - i];
+        matrix->order[variables_number - 1 - i] = variable;
+    }
+    for (int column = 0; column < variables_number; column++)
+        matrix->columns[matrix->order[column]] = column;
+}
+
+/**
+ * @brief Add a non-empty row to the bucket of its leading column.
+ * @param matrix Pointer to sparse matrix.
+ * @param row Row index.
+ * @return Void.
+ */
+void push_sparse_row(t_sparse_matrix *matrix, int row) {
+    if (matrix->rows_length[row] == 0)
+        return;
+    int col = matrix->entries[matrix->rows_start[row]].col;
+    matrix->next_rows[row] = matrix->bucket_heads[col];
+    matrix->bucket_heads[col] = row;
+}
+
+t_error_code fill_sparse_matrix(t_sparse_matrix *matrix, const t_equation *equations, t_component component) {
+    matrix->rows_number = component.equations_number;
+    matrix->cols_number = component.variables_number;
+    matrix->entries_number = 0;
+    matrix->pivots_number = 0;
+    if (!reserve_sparse_entries(matrix, (size_t) component.equations_number * NEIGHBORS_NUMBER))
+        return ERROR_SPARSE_MATRIX_MEMORY_ALLOC;
+    for (int variable = 0; variable < component.variables_number; variable++) {
+        matrix->variables_equations_number[variable] = 0;
+        matrix->degrees[variable] = 0;
+        matrix->bucket_heads[variable] = SPARSE_NO_ROW;
+    }
+    for (int i = 0; i < component.equations_number; i++)
+        for (int k = 0; k < equations[i].variables_number; k++) {
+            int variable = equations[i].variables[k] - component.first_variable;
+            matrix->variables_equations[variable * NEIGHBORS_NUMBER +
+                                        matrix->variables_equations_number[variable]++] = i;
+            matrix->degrees[variable] += equations[i].variables_number - 1;
+        }
+    order_sparse_columns(matrix, equations, component);
+    for (int row = 0; row < component.equations_number; row++) {
+        t_sparse_entry *entries = matrix->entries + matrix->entries_number;
+        int length = equations[row].variables_number;
+        for (int k = 0; k < length; k++) {
+            t_sparse_entry entry = {matrix->columns[equations[row].variables[k] - component.first_variable], 1};
+            int j = k - 1;
+            for (; j >= 0 && entries[j].col > entry.col; j--)
+                entries[j + 1] = entries[j];
+            entries[j + 1] = entry;
+        }
+        matrix->rows_start[row] = (int) matrix->entries_number;
+        matrix->rows_length[row] = length;
+        matrix->biases[row] = equations[row].bias;
+        matrix->entries_number += length;
+        push_sparse_row(matrix, row);
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+/**
+ * @brief Eliminate the leading column of a row by a pivot row (row = pivot * row - factor * pivot_row), divided by
+ * its gcd. The new row is merged into the end of the entries pool.
+ * @param matrix Pointer to sparse matrix, with room for both rows lengths in entries pool.
+ * @param row The changed row index.
+ * @param pivot_row The pivot row index (same leading column).
+ * @return Boolean, true on success, false if a cell exceeds INTEGER_ELIMINATION_LIMIT.
+ */
+bool eliminate_sparse_row(t_sparse_matrix *matrix, int row, int pivot_row) {
+    const t_sparse_entry *pivot_entries = matrix->entries + matrix->rows_start[pivot_row];
+    const t_sparse_entry *row_entries = matrix->entries + matrix->rows_start[row];
+    int pivot_length = matrix->rows_length[pivot_row], row_length = matrix->rows_length[row];
+    int64_t pivot = pivot_entries[0].value, factor = row_entries[0].value;
+    t_sparse_entry *entries = matrix->entries + matrix->entries_number;
+    int length = 0, i = 1, j = 1;
+    int64_t bias = pivot * matrix->biases[row] - factor * matrix->biases[pivot_row];
+    int64_t gcd = get_gcd(0, bias);
+    if (bias > INTEGER_ELIMINATION_LIMIT || bias < -INTEGER_ELIMINATION_LIMIT)
+        return false;
+    while (i < pivot_length || j < row_length) {
+        t_sparse_entry entry;
+        if (j == row_length || (i < pivot_length && pivot_entries[i].col < row_entries[j].col)) {
+            entry.col = pivot_entries[i].col;
+            entry.value = -factor * pivot_entries[i++].value;
+        } else if (i == pivot_length || row_entries[j].col < pivot_entries[i].col) {
+            entry.col = row_entries[j].col;
+            entry.value = pivot * row_entries[j++].value;
+        } else {
+            entry.col = row_entries[j].col;
+            entry.value = pivot * row_entries[j++].value - factor * pivot_entries[i++].value;
+        }
+        if (entry.value == 0)
+            continue;
+        if (entry.value > INTEGER_ELIMINATION_LIMIT || entry.value < -INTEGER_ELIMINATION_LIMIT)
+            return false;
+        gcd = get_gcd(gcd, entry.value);
+        entries[length++] = entry;
+    }
+    if (gcd > 1) {
+        for (int k = 0; k < length; k++)
+            entries[k].value /= gcd;
+        bias /= gcd;
+    }
+    matrix->rows_start[row] = (int) matrix->entries_number;
+    matrix->rows_length[row] = length;
+    matrix->biases[row] = bias;
+    matrix->entries_number += length;
+    return true;
+}
+
+t_error_code sparse_gauss_eliminate(t_sparse_matrix *matrix, bool *is_eliminated) {
+    *is_eliminated = true;
+    for (int col = 0; col < matrix->cols_number; col++) {
+        int pivot_row = SPARSE_NO_ROW;
+        int64_t pivot = 0;
+        for (int row = matrix->bucket_heads[col]; row != SPARSE_NO_ROW; row = matrix->next_rows[row]) {
+            int64_t value = llabs(matrix->entries[matrix->rows_start[row]].value);
+            if (pivot_row == SPARSE_NO_ROW || value < pivot) {
+                pivot_row = row;
+                pivot = value;
+            }
+        }
+        if (pivot_row == SPARSE_NO_ROW)
+            continue;
+        matrix->pivot_rows[matrix->pivots_number++] = pivot_row;
+        for (int row = matrix->bucket_heads[col], next_row; row != SPARSE_NO_ROW; row = next_row) {
+            next_row = matrix->next_rows[row];
+            if (row == pivot_row)
+                continue;
+            if (!reserve_sparse_entries(matrix, matrix->rows_length[row] + matrix->rows_length[pivot_row]))
+                return ERROR_SPARSE_MATRIX_MEMORY_ALLOC;
+            if (!eliminate_sparse_row(matrix, row, pivot_row)) {
+                *is_eliminated = false;
+                return RETURN_CODE_SUCCESS;
+            }
+            push_sparse_row(matrix, row);
+        }
+        matrix->bucket_heads[col] = SPARSE_NO_ROW;
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+int deduce_sparse_variables(t_sparse_matrix *matrix) {
+    int deduced_variables = 0;
+    for (int variable = 0; variable < matrix->cols_number; variable++)
+        matrix->values[variable] = SPARSE_UNDECIDED;
+    for (int i = matrix->pivots_number - 1; i >= 0; i--) {
+        int row = matrix->pivot_rows[i];
+        const t_sparse_entry *entries = matrix->entries + matrix->rows_start[row];
+        int64_t bias = matrix->biases[row], lower_bound = 0, upper_bound = 0;
+        for (int k = 0; k < matrix->rows_length[row]; k++) {
+            int value = matrix->values[matrix->order[entries[k].col]];
+            if (value != SPARSE_UNDECIDED)
+                bias -= value * entries[k].value;
+            else if (entries[k].value < 0)
+                lower_bound += entries[k].value;
+            else
+                upper_bound += entries[k].value;
+        }
+        if (lower_bound == upper_bound || (bias != lower_bound && bias != upper_bound))
+            continue;
+        for (int k = 0; k < matrix->rows_length[row]; k++) {
+            int variable = matrix->order[entries[k].col];
+            if (matrix->values[variable] != SPARSE_UNDECIDED)
+                continue;
+            // At the lower bound positive variables are clear and negative ones are mines, and the other way around.
+            matrix->values[variable] = (entries[k].value > 0) == (bias == upper_bound);
+            deduced_variables++;
+        }
+    }
+    return deduced_variables;
+}
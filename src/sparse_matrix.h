@@ -0,0 +1,115 @@
+/**************************************************************************************************
+ * @file sparse_matrix.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for sparse matrix module, exports sparse exact elimination of large components equations.
+ * Rows are kept as sorted column lists, and columns are ordered along the frontier (reverse Cuthill-McKee),
+ * so elimination of a long, thin component has little fill-in and its memory grows with the component length.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_SPARSE_MATRIX_H
+#define MINESWEEPERSOLVER_SPARSE_MATRIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "error_codes.h"
+#include "board.h"
+#include "frontier.h"
+
+#define SPARSE_MIN_VARIABLES 256    // Smaller components are eliminated over a (SIMD) dense matrix.
+#define SPARSE_MAX_DENSITY 0.05     // Denser components are eliminated over a dense matrix.
+#define SPARSE_NO_ROW -1
+#define SPARSE_UNDECIDED -1
+
+/**
+ * Struct for a non-zero coefficient of a sparse row.
+ */
+struct sparse_entry {
+    int col;
+    int64_t value;
+};
+typedef struct sparse_entry t_sparse_entry;
+
+/**
+ * Struct for sparse equations matrix of a component, and its scratch buffers.
+ * Fixed buffers are allocated once in the size of board cells, and the entries pool grows when needed (rows are
+ * appended to it whenever they change, and it is reset for every component).
+ */
+struct sparse_matrix {
+    int rows_number;
+    int cols_number;
+    int *rows_start;                // Offset of every row entries in pool.
+    int *rows_length;
+    int64_t *biases;
+    int *bucket_heads;              // First row of every leading column.
+    int *next_rows;                 // Next row of same leading column.
+    int *pivot_rows;                // Rows of echelon form, by pivot column.
+    int pivots_number;
+    int *order;                     // Component variable of every column.
+    int *columns;                   // Column of every component variable.
+    int *degrees;                   // Number of neighbor variables (by shared equations) of every component variable.
+    int *variables_equations;       // NEIGHBORS_NUMBER equations indexes for every component variable.
+    int *variables_equations_number;
+    int *values;                    // Deduced value of every component variable, SPARSE_UNDECIDED if not deduced.
+    t_sparse_entry *entries;        // Entries pool.
+    size_t entries_number;
+    size_t entries_capacity;
+};
+typedef struct sparse_matrix t_sparse_matrix;
+
+/**
+ * @brief Initialize sparse matrix buffers.
+ * @param matrix Pointer to sparse matrix.
+ * @param board_size Board size.
+ * @return Error code.
+ */
+t_error_code initialize_sparse_matrix(t_sparse_matrix *matrix, t_board_size board_size);
+
+/**
+ * @brief Free sparse matrix buffers.
+ * @param matrix Pointer to sparse matrix.
+ * @return Void.
+ */
+void free_sparse_matrix(t_sparse_matrix *matrix);
+
+/**
+ * @brief Check whether a component is large and sparse enough to be eliminated over a sparse matrix.
+ * @param equations Component equations.
+ * @param component The component.
+ * @return Boolean, true if sparse elimination should be used.
+ */
+bool is_sparse_component(const t_equation *equations, t_component component);
+
+/**
+ * @brief Fill sparse matrix with component equations, ordering columns by reverse Cuthill-McKee.
+ * Variables are visited breadth first over the variables graph (variables are neighbors if they share an equation),
+ * from a pseudo-peripheral variable and by ascending degree, and columns take the reversed visit order, so the columns
+ * of every equation are close and elimination has little fill-in.
+ * @param matrix Pointer to sparse matrix.
+ * @param equations Component equations.
+ * @param component The component.
+ * @return Error code.
+ */
+t_error_code fill_sparse_matrix(t_sparse_matrix *matrix, const t_equation *equations, t_component component);
+
+/**
+ * @brief Perform exact gcd normalized Gaussian elimination over a sparse matrix.
+ * Rows are bucketed by their leading column, so every column eliminates only the rows that lead with it, and a changed
+ * row is merged from the two sorted rows (pivot * row - factor * pivot_row) and divided by its gcd.
+ * @param matrix Pointer to filled sparse matrix.
+ * @param is_eliminated Pointer to boolean, set to false if a cell exceeds INTEGER_ELIMINATION_LIMIT.
+ * @return Error code.
+ */
+t_error_code sparse_gauss_eliminate(t_sparse_matrix *matrix, bool *is_eliminated);
+
+/**
+ * @brief Deduce variables of an eliminated sparse matrix, from its last echelon row up.
+ * A row whose bias (after substituting deduced variables) meets its lower or upper bound (for 0-1 variables)
+ * deduces all of its variables.
+ * @param matrix Pointer to eliminated sparse matrix, its values are set (0 or 1, or SPARSE_UNDECIDED).
+ * @return Number of deduced variables.
+ */
+int deduce_sparse_variables(t_sparse_matrix *matrix);
+
+#endif //MINESWEEPERSOLVER_SPARSE_MATRIX_H
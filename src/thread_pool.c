@@ -0,0 +1,121 @@
+/**************************************************************************************************
+ * @file thread_pool.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief thread_pool module, runs the independent tasks of a job over persistent threads.
+ * Threads sleep on a condition variable between jobs. A posted job bumps the pool generation, every thread (and the
+ * calling thread) takes tasks by an atomic counter until none are left, and the calling thread waits until all
+ * threads are done with the job, so the results of all tasks are visible once run_pool_tasks returns.
+**************************************************************************************************/
+#include <stdlib.h>
+#include "thread_pool.h"
+
+/**
+ * @brief Run the tasks of current job, until none are left.
+ * @param pool Pointer to pool.
+ * @param worker_index Index of running worker.
+ * @return Void.
+ */
+void run_job_tasks(t_thread_pool *pool, int worker_index) {
+    int task;
+    while ((task = atomic_fetch_add(&pool->next_task, 1)) < pool->tasks_number)
+        pool->routine(pool->context, task, worker_index);
+}
+
+/**
+ * @brief Pool thread routine, runs posted jobs until the pool is closed.
+ * @param thread_ptr Pointer to pool thread.
+ * @return NULL.
+ */
+void *run_pool_thread(void *thread_ptr) {
+    t_pool_thread *thread = (t_pool_thread *) thread_ptr;
+    t_thread_pool *pool = thread->pool;
+    long generation = 0;
+    pthread_mutex_lock(&pool->mutex);
+    while (true) {
+        while (!pool->is_closed && pool->generation == generation)
+            pthread_cond_wait(&pool->job_condition, &pool->mutex);
+        if (pool->is_closed)
+            break;
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+        run_job_tasks(pool, thread->worker_index);
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->busy_threads == 0)
+            pthread_cond_signal(&pool->done_condition);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+t_error_code initialize_thread_pool(t_thread_pool *pool, int workers_number) {
+    pool->workers_number = workers_number > 1 ? workers_number : 1;
+    pool->threads = NULL;
+    pool->started_threads = 0;
+    pool->generation = 0;
+    pool->busy_threads = 0;
+    pool->is_closed = false;
+    pool->tasks_number = 0;
+    atomic_init(&pool->next_task, 0);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->job_condition, NULL);
+    pthread_cond_init(&pool->done_condition, NULL);
+    if (pool->workers_number == 1)
+        return RETURN_CODE_SUCCESS;
+    pool->threads = (t_pool_thread *) calloc(pool->workers_number - 1, sizeof(t_pool_thread));
+    if (!pool->threads) {
+        free_thread_pool(pool);
+        return ERROR_THREAD_POOL_MEMORY_ALLOC;
+    }
+    for (; pool->started_threads < pool->workers_number - 1; pool->started_threads++) {
+        t_pool_thread *thread = &pool->threads[pool->started_threads];
+        thread->worker_index = pool->started_threads + 1;
+        thread->pool = pool;
+        if (pthread_create(&thread->thread, NULL, run_pool_thread, thread)) {
+            free_thread_pool(pool);
+            return ERROR_THREAD_POOL_THREAD_CREATE;
+        }
+    }
+    return RETURN_CODE_SUCCESS;
+}
+
+void free_thread_pool(t_thread_pool *pool) {
+    if (pool->workers_number == 0)
+        return;
+    pthread_mutex_lock(&pool->mutex);
+    pool->is_closed = true;
+    pthread_cond_broadcast(&pool->job_condition);
+    pthread_mutex_unlock(&pool->mutex);
+    for (int i = 0; i < pool->started_threads; i++)
+        pthread_join(pool->threads[i].thread, NULL);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->job_condition);
+    pthread_cond_destroy(&pool->done_condition);
+    free(pool->threads);
+    pool->threads = NULL;
+    pool->started_threads = 0;
+    pool->workers_number = 0;
+}
+
+void run_pool_tasks(t_thread_pool *pool, int tasks_number, bool is_parallel, t_pool_routine routine, void *context) {
+    if (!is_parallel || pool->started_threads == 0 || tasks_number < 2) {
+        for (int task = 0; task < tasks_number; task++)
+            routine(context, task, 0);
+        return;
+    }
+    pthread_mutex_lock(&pool->mutex);
+    pool->routine = routine;
+    pool->context = context;
+    pool->tasks_number = tasks_number;
+    atomic_store(&pool->next_task, 0);
+    pool->busy_threads = pool->started_threads;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->job_condition);
+    pthread_mutex_unlock(&pool->mutex);
+    run_job_tasks(pool, 0);
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->busy_threads > 0)
+        pthread_cond_wait(&pool->done_condition, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+}
@@ -0,0 +1,84 @@
+/**************************************************************************************************
+ * @file thread_pool.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for thread pool module, exports a pool of persistent threads that run the tasks of a job.
+ * A job is a number of independent tasks (e.g. frontier components) and a routine, the calling thread takes part
+ * in running it, and returns once all tasks are done. Tasks write their results into their own slots, so merging
+ * them in task order gives equal results on any number of threads.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_THREAD_POOL_H
+#define MINESWEEPERSOLVER_THREAD_POOL_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "error_codes.h"
+
+/**
+ * Routine of a single task.
+ * @param context Job context.
+ * @param task Task index.
+ * @param worker_index Index of running worker (0 for the calling thread), for per-worker scratch buffers.
+ */
+typedef void (*t_pool_routine)(void *context, int task, int worker_index);
+
+/**
+ * Struct for a pool thread.
+ */
+struct pool_thread {
+    pthread_t thread;
+    int worker_index;
+    struct thread_pool *pool;
+};
+typedef struct pool_thread t_pool_thread;
+
+/**
+ * Struct for thread pool, and the job it runs.
+ */
+struct thread_pool {
+    int workers_number;             // Number of workers, including the calling thread (0 once freed).
+    t_pool_thread *threads;         // Threads of workers 1 to workers_number - 1.
+    int started_threads;
+    pthread_mutex_t mutex;
+    pthread_cond_t job_condition;   // Signaled when a job is posted, or the pool is closed.
+    pthread_cond_t done_condition;  // Signaled when the last thread is done with the job.
+    long generation;                // Number of posted jobs.
+    int busy_threads;               // Threads that are not done with current job.
+    bool is_closed;
+    t_pool_routine routine;
+    void *context;
+    int tasks_number;
+    atomic_int next_task;
+};
+typedef struct thread_pool t_thread_pool;
+
+/**
+ * @brief Initialize thread pool, and start its threads.
+ * @param pool Pointer to pool.
+ * @param workers_number Number of workers, including the calling thread (1 runs all tasks on the calling thread).
+ * @return Error code.
+ */
+t_error_code initialize_thread_pool(t_thread_pool *pool, int workers_number);
+
+/**
+ * @brief Close thread pool, join its threads and free it.
+ * @param pool Pointer to pool.
+ * @return Void.
+ */
+void free_thread_pool(t_thread_pool *pool);
+
+/**
+ * @brief Run all tasks of a job, and return once they are done.
+ * Tasks are taken in index order by the next free worker, so long tasks don't hold the others back.
+ * @param pool Pointer to pool.
+ * @param tasks_number Number of tasks.
+ * @param is_parallel Boolean, false to run all tasks on the calling thread (when the job is too small to share).
+ * @param routine Task routine.
+ * @param context Job context, passed to routine.
+ * @return Void.
+ */
+void run_pool_tasks(t_thread_pool *pool, int tasks_number, bool is_parallel, t_pool_routine routine, void *context);
+
+#endif //MINESWEEPERSOLVER_THREAD_POOL_H
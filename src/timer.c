@@ -0,0 +1,45 @@
+/**************************************************************************************************
+ * @file timer.c
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief timer module, monotonic clock over Windows performance counter or POSIX clock_gettime, and deadlines.
+**************************************************************************************************/
+#ifdef _WIN32
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif
+#include "timer.h"
+
+#define NANOSECONDS_IN_SECOND 1000000000ULL
+
+uint64_t get_time_nanoseconds() {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t) ((double) counter.QuadPart * ((double) NANOSECONDS_IN_SECOND / (double) frequency.QuadPart));
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * NANOSECONDS_IN_SECOND + (uint64_t) now.tv_nsec;
+#endif
+}
+
+uint64_t get_deadline(uint64_t budget_nanoseconds) {
+    uint64_t now = get_time_nanoseconds();
+    return budget_nanoseconds >= NO_DEADLINE - now ? NO_DEADLINE : now + budget_nanoseconds;
+}
+
+bool is_deadline_passed(uint64_t deadline) {
+    return deadline != NO_DEADLINE && get_time_nanoseconds() >= deadline;
+}
+
+uint64_t get_time_left(uint64_t deadline) {
+    if (deadline == NO_DEADLINE)
+        return UINT64_MAX;
+    uint64_t now = get_time_nanoseconds();
+    return now >= deadline ? 0 : deadline - now;
+}
@@ -0,0 +1,45 @@
+/**************************************************************************************************
+ * @file timer.h
+ * @project MinesweeperSolver
+ * @author Yotam Sali
+ * @date 25.5.2020
+ * @brief Header for timer module, exports monotonic clock reading and deadlines.
+**************************************************************************************************/
+#ifndef MINESWEEPERSOLVER_TIMER_H
+#define MINESWEEPERSOLVER_TIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NO_DEADLINE UINT64_MAX
+#define NANOSECONDS_IN_MICROSECOND 1000ULL
+
+/**
+ * @brief Get monotonic clock time.
+ * Only differences between two readings are meaningful.
+ * @return Monotonic time in nanoseconds.
+ */
+uint64_t get_time_nanoseconds();
+
+/**
+ * @brief Get the deadline of a time budget that starts now.
+ * @param budget_nanoseconds Time budget in nanoseconds.
+ * @return Monotonic deadline in nanoseconds (NO_DEADLINE if budget doesn't fit the clock).
+ */
+uint64_t get_deadline(uint64_t budget_nanoseconds);
+
+/**
+ * @brief Check whether a deadline has passed (the clock is not read for NO_DEADLINE).
+ * @param deadline Monotonic deadline in nanoseconds, or NO_DEADLINE.
+ * @return Boolean, true if deadline has passed.
+ */
+bool is_deadline_passed(uint64_t deadline);
+
+/**
+ * @brief Get the time left until a deadline.
+ * @param deadline Monotonic deadline in nanoseconds, or NO_DEADLINE.
+ * @return Time left in nanoseconds (0 if deadline has passed, UINT64_MAX for NO_DEADLINE).
+ */
+uint64_t get_time_left(uint64_t deadline);
+
+#endif //MINESWEEPERSOLVER_TIMER_H